@@ -19,6 +19,8 @@
 
 #include <clap/helpers/plugin.hh>
 #include "engine/engine.h"
+#include "engine/engine-core.h"
+#include "engine/trace-recorder.h"
 #include "presets/preset-manager.h"
 
 #include <clap/helpers/plugin.hxx>
@@ -33,6 +35,7 @@
 #include "sst/basic-blocks/modulators/TransportClapAdapter.h"
 
 #include "ui/plugin-editor.h"
+#include "ui/filter-plot-service.h"
 
 #include <clapwrapper/vst3.h>
 
@@ -66,16 +69,59 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     std::unique_ptr<Engine> engine;
     size_t blockPos{0};
 
+    // Made with the first editor and handed to each later one, so reopening the editor
+    // doesn't rescan the user patches or restart the watcher and prefetch threads.
+    std::shared_ptr<presets::PresetManager> presetManager;
+    // Likewise held from the first editor on, so closing one doesn't join the plot workers
+    // and write the response cache on the UI thread; that waits for the plugin to go.
+    std::shared_ptr<ui::FilterPlotService> plotService;
+
   protected:
     bool activate(double sampleRate, uint32_t minFrameCount,
                   uint32_t maxFrameCount) noexcept override
     {
         // The audio thread is stopped here; seed it from the main-thread source of truth.
         engine->patch.copyValuesFrom(engine->patchMain);
+        engine->setupPolyVoices();
         engine->setSampleRate(sampleRate);
+        engine->setupParallelRender();
+
+        auto latency = Engine::latencyFor(engine->patch);
+        engine->latencyRestartRequested = false;
+        if (latency != engine->reportedLatency)
+        {
+            engine->reportedLatency = latency;
+            if (_host.canUseLatency())
+                _host.latencyChanged();
+        }
+        return true;
+    }
+
+    bool implementsLatency() const noexcept override { return true; }
+    uint32_t latencyGet() const noexcept override
+    {
+        // Before the first activate, say what the main thread patch would run with
+        return isActive() ? engine->reportedLatency : Engine::latencyFor(engine->patchMain);
+    }
+
+    // Offline the patch may ask for its higher quality profile; see Engine::offlineRender
+    bool implementsRender() const noexcept override { return true; }
+    bool renderHasHardRealtimeRequirement() noexcept override { return false; }
+    bool renderSetMode(clap_plugin_render_mode mode) noexcept override
+    {
+        engine->offlineRender.store(mode == CLAP_RENDER_OFFLINE, std::memory_order_relaxed);
         return true;
     }
 
+    // Only reached through the engine's own request_exec from processParallel
+    bool implementsThreadPool() const noexcept override { return true; }
+    void threadPoolExec(uint32_t taskIndex) noexcept override
+    {
+        // The host's pool threads have their own FPU state; set denormals off as process does
+        auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
+        engine->runParallelTask(taskIndex);
+    }
+
     void onMainThread() noexcept override { engine->onMainThread(); }
 
     bool implementsAudioPorts() const noexcept override { return true; }
@@ -103,15 +149,35 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     }
 
     bool implementsNotePorts() const noexcept override { return true; }
-    uint32_t notePortsCount(bool isInput) const noexcept override { return 0; }
+    // Notes only play in poly mode
+    uint32_t notePortsCount(bool isInput) const noexcept override { return isInput ? 1 : 0; }
     bool notePortsInfo(uint32_t index, bool isInput,
                        clap_note_port_info *info) const noexcept override
     {
-        return false;
+        if (!isInput || index != 0)
+            return false;
+        info->id = 8126;
+        info->supported_dialects = CLAP_NOTE_DIALECT_CLAP | CLAP_NOTE_DIALECT_MIDI;
+        info->preferred_dialect = CLAP_NOTE_DIALECT_CLAP;
+        strncpy(info->name, "Poly Notes", sizeof(info->name));
+        return true;
     }
 
     clap_process_status process(const clap_process *process) noexcept override
     {
+        TF_TRACE_SCOPE("audio", "process");
+        // Only timed for the opt in CPU governor
+        auto governed = engine->cpuGovernorOn;
+        auto started = governed ? std::chrono::steady_clock::now()
+                                : std::chrono::steady_clock::time_point{};
+
+        // A change of render mode lands at the start of a control block
+        if (engine->renderModeChanging())
+        {
+            blockPos = 0;
+            engine->updateRenderSetup();
+        }
+
         auto useFeedback = engine->patch.routingNode.feedbackPower > 0.5;
         auto useNoise = engine->patch.routingNode.noisePower > 0.5;
         auto useOS = engine->overSampling;
@@ -160,6 +226,14 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
 #undef CWNS
         }
 
+        double seconds{0};
+        if (governed)
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started)
+                          .count();
+        engine->governorEndProcess(process->audio_outputs->data32[0],
+                                   process->audio_outputs->data32[1], process->frames_count,
+                                   seconds);
+
         return CLAP_PROCESS_CONTINUE;
     }
 
@@ -170,6 +244,12 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
 
         sst::basic_blocks::modulators::fromClapTransport(engine->transport, process->transport);
 
+        if constexpr (Engine::filtersIndependent<routingMode, withFeedback>())
+        {
+            if (engine->parallelRender && !engine->ecoFeedback && !engine->polyMode)
+                return processParallel<routingMode, withFeedback, withNoise, withOS>(process);
+        }
+
         auto ev = process->in_events;
         auto outq = process->out_events;
         auto sz = ev->size(ev);
@@ -184,7 +264,12 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         auto inD = process->audio_inputs->data32;
         auto outD = process->audio_outputs->data32;
 
-        for (auto s = 0U; s < process->frames_count; ++s)
+        // The samples themselves run in the DSP core built for this CPU
+        const auto &core = engineCore();
+        auto render = core.render[(int)routingMode][withFeedback][withNoise][withOS];
+
+        engine->dspTiming.resume();
+        for (auto s = 0U; s < process->frames_count;)
         {
             if (blockPos == 0)
             {
@@ -199,14 +284,100 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
                         nextEvent = nullptr;
                 }
 
+                engine->dspTiming.controlBegin();
+                engine->processControl(outq);
+                // Noise decorrelates the sides, and a block split over two process calls
+                // can't be checked up front; both stay stereo.
+                auto monoOk = !withNoise && s + engine->controlBlockSize <= process->frames_count;
+                engine->chooseMonoBlock(monoOk ? inD[0] + s : nullptr,
+                                        monoOk ? inD[1] + s : nullptr);
+                engine->dspTiming.controlEnd();
+
+                if constexpr (withFeedback)
+                {
+                    if (engine->ecoFeedback && engine->controlBlockSize == blockSize &&
+                        s + blockSize <= process->frames_count)
+                    {
+                        core.renderEco[(int)routingMode][withNoise][withOS](
+                            *engine, inD[0] + s, inD[1] + s, outD[0] + s, outD[1] + s);
+                        s += blockSize;
+                        engine->dspTiming.audioBlockEnd();
+                        continue;
+                    }
+                }
+            }
+
+            // To the end of the control block, or of the buffer
+            auto n = std::min(engine->controlBlockSize - (uint32_t)blockPos,
+                              process->frames_count - s);
+            render(*engine, inD[0] + s, inD[1] + s, outD[0] + s, outD[1] + s, n);
+            s += n;
+
+            blockPos = (blockPos + n) & (engine->controlBlockSize - 1);
+            if (blockPos == 0)
+                engine->dspTiming.audioBlockEnd();
+        }
+        engine->dspTiming.pause();
+
+        while (nextEvent)
+        {
+            handleEvent(nextEvent);
+            nextEventIndex++;
+            if (nextEventIndex < sz)
+                nextEvent = ev->get(ev, nextEventIndex);
+            else
+                nextEvent = nullptr;
+        }
+        return CLAP_PROCESS_CONTINUE;
+    }
+
+    // As processForRouting, but the two filters render as thread pool tasks; see
+    // Engine::filtersIndependent. Events and control still land on the same samples.
+    template <Engine::RoutingModes routingMode, bool withFeedback, bool withNoise, bool withOS>
+    clap_process_status processParallel(const clap_process *process) noexcept
+    {
+        auto ev = process->in_events;
+        auto outq = process->out_events;
+        auto sz = ev->size(ev);
+
+        const clap_event_header_t *nextEvent{nullptr};
+        uint32_t nextEventIndex{0};
+        if (sz != 0)
+        {
+            nextEvent = ev->get(ev, nextEventIndex);
+        }
+
+        auto inD = process->audio_inputs->data32;
+        auto outD = process->audio_outputs->data32;
+
+        // Only control is timed here; the filters run in the flushes, under trace scopes.
+        engine->chooseMonoBlock(nullptr, nullptr); // the split path is always stereo
+        engine->beginParallel<routingMode, withFeedback, withOS>(outD[0], outD[1]);
+        for (auto s = 0U; s < process->frames_count; ++s)
+        {
+            if (blockPos == 0)
+            {
+                while (nextEvent && nextEvent->time <= s)
+                {
+                    handleEvent(nextEvent);
+                    nextEventIndex++;
+                    if (nextEventIndex < sz)
+                        nextEvent = ev->get(ev, nextEventIndex);
+                    else
+                        nextEvent = nullptr;
+                }
+
+                engine->dspTiming.controlBegin();
                 engine->processControl(outq);
+                engine->dspTiming.controlEnd();
+                engine->planParallelBlock();
             }
 
-            engine->processAudio<routingMode, withFeedback, withNoise, withOS>(
-                inD[0][s], inD[1][s], outD[0][s], outD[1][s]);
+            engine->prepareParallelSample<withNoise, withOS>(inD[0][s], inD[1][s]);
 
-            blockPos = (blockPos + 1) & (blockSize - 1);
+            blockPos = (blockPos + 1) & (engine->controlBlockSize - 1);
         }
+        engine->endParallel();
 
         while (nextEvent)
         {
@@ -240,6 +411,44 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
             }
             break;
 
+            case CLAP_EVENT_PARAM_MOD:
+            {
+                auto pevt = reinterpret_cast<const clap_event_param_mod *>(nextEvent);
+                engine->paramModulation(pevt->param_id, pevt->port_index, pevt->channel,
+                                        pevt->key, pevt->note_id, (float)pevt->amount);
+            }
+            break;
+
+            case CLAP_EVENT_NOTE_ON:
+            case CLAP_EVENT_NOTE_OFF:
+            case CLAP_EVENT_NOTE_CHOKE:
+            {
+                auto nevt = reinterpret_cast<const clap_event_note *>(nextEvent);
+                if (nextEvent->type == CLAP_EVENT_NOTE_ON)
+                    engine->polyNoteOn(nevt->port_index, nevt->channel, nevt->key,
+                                       nevt->note_id);
+                else if (nextEvent->type == CLAP_EVENT_NOTE_OFF)
+                    engine->polyNoteOff(nevt->port_index, nevt->channel, nevt->key,
+                                        nevt->note_id);
+                else
+                    engine->polyNoteChoke(nevt->port_index, nevt->channel, nevt->key,
+                                          nevt->note_id);
+            }
+            break;
+
+            case CLAP_EVENT_MIDI:
+            {
+                auto mevt = reinterpret_cast<const clap_event_midi *>(nextEvent);
+                auto msg = mevt->data[0] & 0xF0;
+                auto chan = (int16_t)(mevt->data[0] & 0x0F);
+                auto key = (int16_t)mevt->data[1];
+                if (msg == 0x90 && mevt->data[2] > 0)
+                    engine->polyNoteOn(mevt->port_index, chan, key, -1);
+                else if (msg == 0x80 || msg == 0x90)
+                    engine->polyNoteOff(mevt->port_index, chan, key, -1);
+            }
+            break;
+
             default:
             {
                 SQLOG("Unknown inbound event of type " << nextEvent->type);
@@ -253,6 +462,7 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     bool implementsState() const noexcept override { return true; }
     bool stateSave(const clap_ostream *ostream) noexcept override
     {
+        TF_TRACE_SCOPE("main", "stateSave");
         // patchMain is authoritative. If no editor is open to keep it current, drain any
         // pending audio-thread updates into it first (we are the only consumer then).
         if (!engine->editorActive.load())
@@ -263,6 +473,7 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
 
     bool stateLoad(const clap_istream *istream) noexcept override
     {
+        TF_TRACE_SCOPE("main", "stateLoad");
         // Load into a temp first so a parse failure never leaves patchMain half-written.
         auto tmp = std::make_unique<Patch>();
         if (!sst::plugininfra::patch_support::inStreamToPatch(istream, *tmp))
@@ -333,9 +544,14 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     ADD_SHIM_LINUX_TIMER(clapJuceShim)
     std::unique_ptr<juce::Component> createEditor() override
     {
+        if (!presetManager)
+            presetManager = std::make_shared<presets::PresetManager>(_host.host());
+        if (!plotService)
+            plotService = ui::FilterPlotService::instance();
+
         auto res = std::make_unique<baconpaul::twofilters::ui::PluginEditor>(
             engine->patchMain, engine->audioToMain, engine->mainToAudio, engine->editorActive,
-            engine->uiForceRebuild, _host.host());
+            engine->uiForceRebuild, engine->telemetryAvailable, _host.host(), presetManager);
 
         res->onZoomChanged = [this](auto f)
         {
@@ -349,6 +565,23 @@ struct TwoFilters : public plugHelper_t, sst::clap_juce_shim::EditorProvider
             }
         };
 
+        res->describeMemory = [this]()
+        {
+            auto r = engine->memoryReport();
+            if (presetManager)
+                r.entries.emplace_back("Preset manager",
+                                       sizeof(presets::PresetManager) +
+                                           presetManager->userPatches.capacity() *
+                                               sizeof(fs::path));
+            std::string txt;
+            for (const auto &[n, b] : r.entries)
+                txt += n + ": " + std::to_string((b + 1023) / 1024) + "kb\n";
+            txt += "Total: " + std::to_string((r.total() + 1023) / 1024) + "kb";
+            return txt;
+        };
+
+        res->prepareFilter = [this](int f) { engine->prepareStandbyFilter(f); };
+
         onShow = [e = res.get()]()
         {
             // SQLOG("onShow with zoom factor " << e->zoomFactor);
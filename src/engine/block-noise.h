@@ -0,0 +1,95 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_BLOCK_NOISE_H
+#define BACONPAUL_TWOFILTERS_ENGINE_BLOCK_NOISE_H
+
+#include <cstdint>
+
+#include "sst/basic-blocks/dsp/CorrelatedNoise.h"
+
+#include "configuration.h"
+#include "engine/dsp-kernels.h"
+
+namespace baconpaul::twofilters
+{
+/*
+ * A control block of stereo noise at a time, so the audio loop only reads a buffer. The
+ * uniform values come from a counter based generator: each is a hash of (key, counter),
+ * with no state carried from one to the next, so the fill loop has no dependency chain and
+ * vectorises (it is one of the DspKernels). They then go through the same
+ * correlated_noise_o2mk2 shaping the per sample code used, which is recursive; the two
+ * channels run side by side in one loop.
+ *
+ * Same distribution as RNG::unifPM1 (uniform on [-1, 1), 24 bits), different sequence.
+ */
+struct BlockNoise
+{
+    static constexpr uint32_t maxSamples{blockSize * 2}; // oversampled
+
+    float values[2][maxSamples]{};
+
+    void seed(uint64_t s)
+    {
+        key = (uint32_t)(s ^ (s >> 32));
+        counter = 0;
+        state[0][0] = state[0][1] = state[1][0] = state[1][1] = 0;
+    }
+
+    // The next n values per channel (n <= maxSamples), from the start of values
+    void fill(uint32_t n)
+    {
+        float u[2][maxSamples];
+        dspKernels().noiseUniform(key, counter, n, u[0], u[1]);
+        counter += 2 * n;
+
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            values[0][i] = sst::basic_blocks::dsp::correlated_noise_o2mk2_supplied_value(
+                state[0][0], state[0][1], 0, u[0][i]);
+            values[1][i] = sst::basic_blocks::dsp::correlated_noise_o2mk2_supplied_value(
+                state[1][0], state[1][1], 0, u[1][i]);
+        }
+    }
+
+    // lowbias32 (Wellons) on the counter, offset by the key
+    static uint32_t hash(uint32_t k, uint64_t c)
+    {
+        return hash(k, (uint32_t)c, (uint32_t)(c >> 32));
+    }
+    // The same on the counter's halves, which lets a fill loop stay in 32 bit lanes
+    static uint32_t hash(uint32_t k, uint32_t lo, uint32_t hi)
+    {
+        uint32_t x = lo * 0x9E3779B9u + k + hi * 0x85EBCA6Bu;
+        x ^= x >> 16;
+        x *= 0x21F0AAADu;
+        x ^= x >> 15;
+        x *= 0x735A2D97u;
+        x ^= x >> 15;
+        return x;
+    }
+    // 24 bits, so the signed conversion is exact and vectorises
+    static float toPM1(uint32_t h)
+    {
+        return (float)(int32_t)(h >> 8) * (2.f / (1 << 24)) - 1.f;
+    }
+
+  private:
+    uint32_t key{0x9E3779B9};
+    uint64_t counter{0}; // 64 bits, so the sequence never repeats in practice
+    float state[2][2]{};
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_BLOCK_NOISE_H
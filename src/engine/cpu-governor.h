@@ -0,0 +1,204 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_CPU_GOVERNOR_H
+#define BACONPAUL_TWOFILTERS_ENGINE_CPU_GOVERNOR_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "configuration.h"
+
+namespace baconpaul::twofilters
+{
+/*
+ * An opt in CPU governor, for live rigs where a click is better than a dropout. The plugin
+ * times each process call against the real time its frames stand for; when that load stays
+ * high the governor steps quality down one level at a time, and back up once there has been
+ * headroom for a while. A step up that overloads again straight away doubles the wait
+ * before the next one.
+ *
+ * This is the measurement and the output stage. The engine owns what each level means and
+ * when a change is applied; a level that rebuilds the filters fades the whole output out,
+ * switches while silent and fades back in. Dropping oversampling would shorten the latency
+ * the host was told, so the output is padded by the difference instead of restarting.
+ */
+struct CpuGovernor
+{
+    enum Level : uint32_t
+    {
+        Full,
+        NoOversampling,
+        CoarseControl, // a control block every 2 * blockSize samples
+        LowTelemetry,  // a quarter of the meter work, and plots reduced in the editor
+        numLevels
+    };
+    static const char *levelName(uint32_t l)
+    {
+        switch (l)
+        {
+        case Full:
+            return "Full";
+        case NoOversampling:
+            return "No Oversampling";
+        case CoarseControl:
+            return "Coarse Control";
+        case LowTelemetry:
+            return "Low Telemetry";
+        }
+        return "?";
+    }
+
+    static constexpr double windowSeconds{0.25};
+    static constexpr float stepDownLoad{0.7f}, stepUpLoad{0.35f};
+    static constexpr uint32_t windowsToStepDown{2}, windowsToStepUp{8}, maxUpBackoff{8};
+    static constexpr double fadeSeconds{0.005};
+
+    void setSampleRate(double sr)
+    {
+        sampleRate = sr;
+        windowFrames = (uint32_t)(sr * windowSeconds);
+        fadeStep = (float)(1.0 / (sr * fadeSeconds));
+    }
+
+    // The level measurement asks for, and the last window's load
+    uint32_t target{Full};
+    float load{0};
+
+    // One process call; true when target changed
+    bool record(double seconds, uint32_t frames)
+    {
+        busy += seconds;
+        framesSeen += frames;
+        if (framesSeen < windowFrames)
+            return false;
+
+        load = (float)(busy * sampleRate / framesSeen);
+        busy = 0;
+        framesSeen = 0;
+        windowsSinceChange++;
+
+        if (load > stepDownLoad)
+        {
+            under = 0;
+            if (++over >= windowsToStepDown && target + 1 < numLevels)
+            {
+                if (steppedUp && windowsSinceChange < windowsToStepUp * upBackoff)
+                    upBackoff = std::min(upBackoff * 2, maxUpBackoff);
+                target++;
+                over = 0;
+                steppedUp = false;
+                windowsSinceChange = 0;
+                return true;
+            }
+        }
+        else if (load < stepUpLoad)
+        {
+            over = 0;
+            if (++under >= windowsToStepUp * upBackoff && target > Full)
+            {
+                target--;
+                under = 0;
+                steppedUp = true;
+                windowsSinceChange = 0;
+                return true;
+            }
+        }
+        else
+        {
+            over = 0;
+            under = 0;
+        }
+
+        // A long spell with no change forgives earlier backoff
+        if (windowsSinceChange >= windowsToStepUp * maxUpBackoff * 2)
+        {
+            upBackoff = 1;
+            windowsSinceChange = 0;
+        }
+        return false;
+    }
+
+    // Back to full quality with nothing measured and nothing padded or faded
+    void reset()
+    {
+        target = Full;
+        load = 0;
+        busy = 0;
+        framesSeen = 0;
+        over = under = windowsSinceChange = 0;
+        upBackoff = 1;
+        steppedUp = false;
+        gain = gainTarget = 1;
+        padSamples = padPos = priming = 0;
+    }
+
+    // Output stage, run over each host buffer once it is rendered
+    static constexpr uint32_t padCapacity{64};
+    static_assert((padCapacity & (padCapacity - 1)) == 0);
+    float gain{1}, gainTarget{1};
+    uint32_t padSamples{0};
+
+    bool outputIdle() const { return gain == 1.f && gainTarget == 1.f && padSamples == 0; }
+
+    // A new pad starts silent and holds any fade in until it has filled
+    void setPad(uint32_t n)
+    {
+        n = std::min(n, padCapacity - 1);
+        if (n != padSamples)
+        {
+            priming = n;
+            std::fill(&pad[0][0], &pad[0][0] + 2 * padCapacity, 0.f);
+        }
+        padSamples = n;
+    }
+
+    void processOutput(float *L, float *R, uint32_t n)
+    {
+        if (outputIdle())
+            return;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (padSamples)
+            {
+                pad[0][padPos] = L[i];
+                pad[1][padPos] = R[i];
+                auto rp = (padPos - padSamples) & (padCapacity - 1);
+                L[i] = pad[0][rp];
+                R[i] = pad[1][rp];
+                padPos = (padPos + 1) & (padCapacity - 1);
+            }
+            if (priming)
+                priming--;
+            else if (gain != gainTarget)
+                gain = gain < gainTarget ? std::min(gain + fadeStep, gainTarget)
+                                         : std::max(gain - fadeStep, gainTarget);
+            L[i] *= gain;
+            R[i] *= gain;
+        }
+    }
+
+  private:
+    double sampleRate{48000}, busy{0};
+    uint32_t windowFrames{12000}, framesSeen{0};
+    uint32_t over{0}, under{0}, upBackoff{1}, windowsSinceChange{0};
+    bool steppedUp{false};
+
+    float fadeStep{1.f / 240};
+    float pad[2][padCapacity]{};
+    uint32_t padPos{0}, priming{0};
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_CPU_GOVERNOR_H
@@ -0,0 +1,156 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "dsp-kernels.h"
+
+#include <initializer_list>
+
+#include "block-noise.h"
+#include "engine-core.h"
+
+#if TWOFILTERS_CPU_DISPATCH && (defined(__x86_64__) || defined(__i386__)) &&                      \
+    (defined(__GNUC__) || defined(__clang__))
+#define TWOFILTERS_KERNEL_VARIANTS 1
+#else
+#define TWOFILTERS_KERNEL_VARIANTS 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TF_KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define TF_KERNEL_INLINE __forceinline
+#endif
+
+namespace baconpaul::twofilters
+{
+namespace
+{
+// One body per kernel, inlined into each level's wrapper so the compiler vectorises it for
+// that level. The sixteen partial sums fill one AVX-512 register, two AVX2 or four SSE ones,
+// and fold in the same order on every level; with -ffp-contract=off no level fuses them.
+TF_KERNEL_INLINE float dotBody(const float *a, const float *b, int n)
+{
+    float acc[16]{};
+    for (int i = 0; i < n; i += 16)
+        for (int k = 0; k < 16; ++k)
+            acc[k] += a[i + k] * b[i + k];
+    for (int w = 8; w > 0; w >>= 1)
+        for (int k = 0; k < w; ++k)
+            acc[k] += acc[k + w];
+    return acc[0];
+}
+
+TF_KERNEL_INLINE void noiseBody(uint32_t key, uint64_t counter, uint32_t n, float *out0,
+                                float *out1)
+{
+    // counter + j in halves, carrying by hand
+    auto lo = (uint32_t)counter;
+    auto hi = (uint32_t)(counter >> 32);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t l0 = lo + 2 * i, l1 = l0 + 1;
+        out0[i] = BlockNoise::toPM1(BlockNoise::hash(key, l0, hi + (l0 < lo)));
+        out1[i] = BlockNoise::toPM1(BlockNoise::hash(key, l1, hi + (l1 < lo)));
+    }
+}
+
+float dotBaseline(const float *a, const float *b, int n) { return dotBody(a, b, n); }
+void noiseBaseline(uint32_t key, uint64_t counter, uint32_t n, float *out0, float *out1)
+{
+    noiseBody(key, counter, n, out0, out1);
+}
+const DspKernels baselineKernels{DspKernels::Level::Baseline, "Baseline", dotBaseline,
+                                 noiseBaseline, twofiltersEngineCoreBaseline};
+
+#if TWOFILTERS_CORE_VARIANTS
+#define TF_CORE_AVX2 twofiltersEngineCoreAVX2
+#define TF_CORE_AVX512 twofiltersEngineCoreAVX512
+#else
+#define TF_CORE_AVX2 twofiltersEngineCoreBaseline
+#define TF_CORE_AVX512 twofiltersEngineCoreBaseline
+#endif
+
+#if TWOFILTERS_KERNEL_VARIANTS
+#define TF_AVX2 __attribute__((target("avx2,fma")))
+#define TF_AVX512 __attribute__((target("avx512f,avx2,fma")))
+
+TF_AVX2 float dotAVX2(const float *a, const float *b, int n) { return dotBody(a, b, n); }
+TF_AVX2 void noiseAVX2(uint32_t key, uint64_t counter, uint32_t n, float *out0, float *out1)
+{
+    noiseBody(key, counter, n, out0, out1);
+}
+const DspKernels avx2Kernels{DspKernels::Level::AVX2, "AVX2", dotAVX2, noiseAVX2, TF_CORE_AVX2};
+
+TF_AVX512 float dotAVX512(const float *a, const float *b, int n) { return dotBody(a, b, n); }
+TF_AVX512 void noiseAVX512(uint32_t key, uint64_t counter, uint32_t n, float *out0, float *out1)
+{
+    noiseBody(key, counter, n, out0, out1);
+}
+const DspKernels avx512Kernels{DspKernels::Level::AVX512, "AVX-512", dotAVX512, noiseAVX512,
+                               TF_CORE_AVX512};
+
+#undef TF_AVX2
+#undef TF_AVX512
+#endif
+#undef TF_CORE_AVX2
+#undef TF_CORE_AVX512
+} // namespace
+
+const DspKernels *activeDspKernels{&baselineKernels};
+
+const DspKernels *DspKernels::forLevel(Level l)
+{
+    switch (l)
+    {
+    case Level::Baseline:
+        return &baselineKernels;
+#if TWOFILTERS_KERNEL_VARIANTS
+    case Level::AVX2:
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return &avx2Kernels;
+        break;
+    case Level::AVX512:
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") &&
+            __builtin_cpu_supports("fma"))
+            return &avx512Kernels;
+        break;
+#endif
+    default:
+        break;
+    }
+    return nullptr;
+}
+
+const DspKernels &DspKernels::best()
+{
+    for (auto l : {Level::AVX512, Level::AVX2})
+        if (auto *k = forLevel(l))
+            return *k;
+    return baselineKernels;
+}
+
+void selectDspKernels()
+{
+    // Once, before any engine processes, so no audio thread sees the switch
+    static const bool selected = []()
+    {
+        activeDspKernels = &DspKernels::best();
+        return true;
+    }();
+    (void)selected;
+}
+} // namespace baconpaul::twofilters
@@ -0,0 +1,60 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_DSP_KERNELS_H
+#define BACONPAUL_TWOFILTERS_ENGINE_DSP_KERNELS_H
+
+#include <cstdint>
+
+namespace baconpaul::twofilters
+{
+struct EngineCore;
+
+/*
+ * The code built once per x86 instruction set level, picked from the CPU when the first
+ * engine is made: the hot loops the engine owns (the linear phase half band's dot products
+ * and the block noise generator), and the DSP core; see EngineCore.
+ *
+ * Nothing is built to contract a multiply and add, so every level gives the same bits.
+ */
+struct DspKernels
+{
+    enum struct Level
+    {
+        Baseline,
+        AVX2,
+        AVX512
+    };
+    Level level;
+    const char *name;
+
+    // sum of a[i] * b[i], for n a multiple of 16
+    float (*dot)(const float *a, const float *b, int n);
+    // n uniform values on [-1, 1) per channel, from the block noise counter hash
+    void (*noiseUniform)(uint32_t key, uint64_t counter, uint32_t n, float *out0, float *out1);
+    // The DSP core for this level, or the baseline's where the build has none
+    const EngineCore *(*core)();
+
+    // nullptr where the build or the CPU can't run that level
+    static const DspKernels *forLevel(Level l);
+    // The best this CPU runs; Engine's constructor makes it the active set
+    static const DspKernels &best();
+};
+
+extern const DspKernels *activeDspKernels; // the baseline until best() is selected
+inline const DspKernels &dspKernels() { return *activeDspKernels; }
+void selectDspKernels();
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_DSP_KERNELS_H
@@ -0,0 +1,154 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_DSP_TIMING_H
+#define BACONPAUL_TWOFILTERS_ENGINE_DSP_TIMING_H
+
+#include <array>
+#include <cstdint>
+
+#if TWOFILTERS_DSP_TIMING
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define TWOFILTERS_DSP_TIMING_RDTSC 1
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace baconpaul::twofilters
+{
+/*
+ * Audio thread cost of each engine block, split into processControl and the blockSize
+ * processAudio calls that follow it. Audio blocks can straddle host process calls, so the
+ * audio side is timed in stretches (pause / resume around the host's buffer) and recorded
+ * once the block completes.
+ *
+ * Everything is owned by the audio thread: it records, summarises and resets, and only the
+ * summary leaves, as AudioToMainMsg::UPDATE_DSP_TIMING. Without TWOFILTERS_DSP_TIMING (the
+ * DSP_TIMING cmake option) every hook is an empty inline function.
+ */
+struct DspTiming
+{
+#if TWOFILTERS_DSP_TIMING
+#if TWOFILTERS_DSP_TIMING_RDTSC
+    static constexpr const char *unitName{"cycles"};
+    static uint64_t now() { return __rdtsc(); }
+#else
+    static constexpr const char *unitName{"ns"};
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+#endif
+
+    // Four buckets per octave: the top set bit and the two bits below it.
+    struct Histogram
+    {
+        static constexpr int subBits{2}, numBuckets{64 << subBits};
+        std::array<uint32_t, numBuckets> buckets{};
+        uint32_t count{0};
+        uint64_t worst{0};
+
+        static int bucketFor(uint64_t v)
+        {
+            if (v < (1 << subBits))
+                return (int)v;
+            int msb{63};
+            while (!(v & (1ULL << msb)))
+                msb--;
+            auto sub = (v >> (msb - subBits)) & ((1 << subBits) - 1);
+            return ((msb - subBits + 1) << subBits) + (int)sub;
+        }
+        static uint64_t bucketTop(int b)
+        {
+            if (b < (1 << subBits))
+                return (uint64_t)b + 1;
+            auto msb = (b >> subBits) + subBits - 1;
+            auto sub = (uint64_t)(b & ((1 << subBits) - 1));
+            return ((1ULL << subBits) + sub + 1) << (msb - subBits);
+        }
+
+        void record(uint64_t v)
+        {
+            buckets[bucketFor(v)]++;
+            count++;
+            worst = v > worst ? v : worst;
+        }
+        // The top of the bucket holding the p-th fraction of samples; 0 when empty.
+        uint64_t percentile(double p) const
+        {
+            auto target = (uint64_t)(p * count);
+            uint64_t seen{0};
+            for (int b = 0; b < numBuckets; ++b)
+            {
+                seen += buckets[b];
+                if (seen > target)
+                    return bucketTop(b);
+            }
+            return 0;
+        }
+        void reset()
+        {
+            buckets.fill(0);
+            count = 0;
+            worst = 0;
+        }
+    } control, audio;
+
+    void controlBegin() { t0 = now(); }
+    void controlEnd()
+    {
+        auto t = now();
+        control.record(t - t0);
+        stretchStart = t;
+        pending = 0;
+        inBlock = true;
+    }
+    void audioBlockEnd()
+    {
+        audio.record(pending + now() - stretchStart);
+        inBlock = false;
+    }
+    void pause()
+    {
+        if (inBlock)
+            pending += now() - stretchStart;
+    }
+    void resume()
+    {
+        if (inBlock)
+            stretchStart = now();
+    }
+
+  private:
+    uint64_t t0{0}, stretchStart{0}, pending{0};
+    bool inBlock{false};
+#else
+    void controlBegin() {}
+    void controlEnd() {}
+    void audioBlockEnd() {}
+    void pause() {}
+    void resume() {}
+#endif
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_DSP_TIMING_H
@@ -0,0 +1,109 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "engine/engine-core.h"
+#include "engine/engine.h"
+
+// Built once per level; CMake names the level for the extra builds
+#ifndef TWOFILTERS_CORE_LEVEL
+#define TWOFILTERS_CORE_LEVEL Baseline
+#endif
+#define TF_CORE_CAT_(a, b) a##b
+#define TF_CORE_CAT(a, b) TF_CORE_CAT_(a, b)
+#define TF_CORE_STR_(a) #a
+#define TF_CORE_STR(a) TF_CORE_STR_(a)
+
+namespace baconpaul::twofilters
+{
+namespace
+{
+using RM = Engine::RoutingModes;
+
+void configureFilter(sst::filtersplusplus::Filter &flt, sst::filtersplusplus::FilterModel model,
+                     const sst::filtersplusplus::ModelConfig &cfg, combDelay_t *delays,
+                     double sampleRate, uint32_t blockSamples, bool quad)
+{
+    flt.setFilterModel(model);
+    flt.setModelConfiguration(cfg);
+    if (quad)
+        flt.setQuad();
+    else
+        flt.setStereo();
+    flt.setSampleRateAndBlockSize(sampleRate, blockSamples);
+    for (int i = 0; i < 4; ++i)
+        flt.provideDelayLine(i, delays[i]);
+    if (!flt.prepareInstance())
+        SQLOG("Failed to prepare filter instance");
+    flt.reset();
+}
+
+template <RM mode, bool fb, bool withNoise, bool withOS>
+void render(Engine &e, const float *inL, const float *inR, float *outL, float *outR, uint32_t n)
+{
+    if (e.polyMode)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+            e.processPoly<mode, fb, withNoise, withOS>(inL[i], inR[i], outL[i], outR[i]);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < n; ++i)
+            e.processAudio<mode, fb, withNoise, withOS>(inL[i], inR[i], outL[i], outR[i]);
+    }
+}
+
+template <RM mode, bool withNoise, bool withOS>
+void renderEco(Engine &e, const float *inL, const float *inR, float *outL, float *outR)
+{
+    e.processBlockEco<mode, withNoise, withOS>(inL, inR, outL, outR);
+}
+
+template <int m> void fillMode(EngineCore &c)
+{
+    constexpr auto mode = (RM)m;
+    c.render[m][0][0][0] = render<mode, false, false, false>;
+    c.render[m][0][0][1] = render<mode, false, false, true>;
+    c.render[m][0][1][0] = render<mode, false, true, false>;
+    c.render[m][0][1][1] = render<mode, false, true, true>;
+    c.render[m][1][0][0] = render<mode, true, false, false>;
+    c.render[m][1][0][1] = render<mode, true, false, true>;
+    c.render[m][1][1][0] = render<mode, true, true, false>;
+    c.render[m][1][1][1] = render<mode, true, true, true>;
+
+    c.renderEco[m][0][0] = renderEco<mode, false, false>;
+    c.renderEco[m][0][1] = renderEco<mode, false, true>;
+    c.renderEco[m][1][0] = renderEco<mode, true, false>;
+    c.renderEco[m][1][1] = renderEco<mode, true, true>;
+}
+
+EngineCore makeCore()
+{
+    EngineCore c{};
+    c.name = TF_CORE_STR(TWOFILTERS_CORE_LEVEL);
+    c.configureFilter = configureFilter;
+    fillMode<(int)RM::Serial>(c);
+    fillMode<(int)RM::Parallel_FBBoth>(c);
+    fillMode<(int)RM::Parallel_FBOne>(c);
+    fillMode<(int)RM::Parallel_FBEach>(c);
+    return c;
+}
+} // namespace
+
+extern "C" const EngineCore *TF_CORE_CAT(twofiltersEngineCore, TWOFILTERS_CORE_LEVEL)()
+{
+    static const EngineCore core = makeCore();
+    return &core;
+}
+} // namespace baconpaul::twofilters
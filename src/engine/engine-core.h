@@ -0,0 +1,72 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_ENGINE_CORE_H
+#define BACONPAUL_TWOFILTERS_ENGINE_ENGINE_CORE_H
+
+#include <cstdint>
+
+#include "sst/filters++.h"
+
+#include "engine/dsp-kernels.h"
+#include "engine/poly-voices.h"
+
+namespace baconpaul::twofilters
+{
+struct Engine;
+
+/*
+ * The DSP core: setting up a filter, so that filters++ hands back filter kernels built with
+ * the core, and the per sample render paths (processAudio, processPoly, processBlockEco)
+ * with the IIR and linear phase half bands inlined into them.
+ *
+ * engine-core.cpp is built for the baseline and, with CPU_DISPATCH, again for AVX2 and
+ * AVX-512. Each extra build is linked into one object with every symbol but its entry made
+ * local, so its copies of the inline engine, filters++ and half band code are never merged
+ * with another level's. DspKernels picks the level; every level renders the same bits, as
+ * all are built without contracting multiplies and adds.
+ */
+struct EngineCore
+{
+    static constexpr int numModes{4};
+
+    using configure_t = void (*)(sst::filtersplusplus::Filter &flt,
+                                 sst::filtersplusplus::FilterModel model,
+                                 const sst::filtersplusplus::ModelConfig &cfg,
+                                 combDelay_t *delays, double sampleRate, uint32_t blockSamples,
+                                 bool quad);
+    // n samples, none of them past the end of the current control block
+    using render_t = void (*)(Engine &e, const float *inL, const float *inR, float *outL,
+                              float *outR, uint32_t n);
+    // One whole block straight after its processControl, with eco feedback on
+    using renderEco_t = void (*)(Engine &e, const float *inL, const float *inR, float *outL,
+                                 float *outR);
+
+    const char *name;
+    configure_t configureFilter;
+    render_t render[numModes][2][2][2];    // [mode][feedback][noise][oversampling]
+    renderEco_t renderEco[numModes][2][2]; // [mode][noise][oversampling]
+};
+
+// Unmangled, so the link step can keep just these global
+extern "C" const EngineCore *twofiltersEngineCoreBaseline();
+#if TWOFILTERS_CORE_VARIANTS
+extern "C" const EngineCore *twofiltersEngineCoreAVX2();
+extern "C" const EngineCore *twofiltersEngineCoreAVX512();
+#endif
+
+inline const EngineCore &engineCore() { return *dspKernels().core(); }
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_ENGINE_CORE_H
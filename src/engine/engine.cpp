@@ -14,11 +14,16 @@
  */
 
 #include "engine/engine.h"
+#include "engine/engine-core.h"
 #include "engine/steplfo_songpos.h"
+#include "engine/trace-recorder.h"
 #include "sst/cpputils/constructors.h"
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/PanLaws.h"
 
+#include <random>
+#include <utility>
+
 #include "libMTSClient.h"
 
 namespace baconpaul::twofilters
@@ -29,13 +34,36 @@ int debugLevel{0};
 namespace mech = sst::basic_blocks::mechanics;
 namespace sdsp = sst::basic_blocks::dsp;
 
-Engine::Engine() : lfos{tuningProvider, tuningProvider}, hrUp{6, true}, hrDn{6, true}
+Engine::Engine()
+    : lfos{sharedTuningProvider(), sharedTuningProvider()}, hrUp{6, true}, hrDn{6, true}
 {
-    tuningProvider.init();
+    selectDspKernels();
     updateLfoStorage();
+
+    for (auto &slot : filterSlots)
+        for (auto &u : slot)
+            u = std::make_unique<FilterUnit>();
+
+    std::random_device rd;
+    noise.seed(((uint64_t)rd() << 32) | rd());
 }
 
-Engine::~Engine() {}
+sst::basic_blocks::tables::EqualTuningProvider &Engine::sharedTuningProvider()
+{
+    static sst::basic_blocks::tables::EqualTuningProvider tp;
+    static bool initialised = (tp.init(), true); // thread safe, like any function static
+    (void)initialised;
+    return tp;
+}
+
+Engine::~Engine()
+{
+    collectRetiredFilters();
+    while (retireBacklog)
+        delete std::exchange(retireBacklog, retireBacklog->nextRetired);
+    for (auto &sf : standbyFilter)
+        delete sf.exchange(nullptr);
+}
 
 void Engine::setSampleRate(double sr)
 {
@@ -43,14 +71,15 @@ void Engine::setSampleRate(double sr)
     sampleRateInv = 1.0 / sr;
     for (auto &[i, p] : patch.paramMap)
     {
-        p->lag.setRateInMilliseconds(1000.0 * 64.0 / 48000.0, sampleRate, 1.0 / blockSize);
+        p->lag.setRateInMilliseconds(1000.0 * 64.0 / 48000.0, sampleRate, 1.0 / controlBlockSize);
         p->lag.snapTo(p->value);
     }
     paramLagSet.removeAll();
 
     vuPeak.setSampleRate(sampleRate);
+    cpuGovernor.setSampleRate(sampleRate);
 
-    audioToMain.push({AudioToMainMsg::SEND_SAMPLE_RATE, 0, (float)sampleRate});
+    pushToMain({AudioToMainMsg::SEND_SAMPLE_RATE, 0, (float)sampleRate});
 
     auto nq = sampleRate * 0.495;
     // so we are note from 69 which is 440
@@ -65,7 +94,7 @@ void Engine::setSampleRate(double sr)
     }
 
     for (auto &pl : panLag)
-        pl.setRateInMilliseconds(25, sampleRate, 1.0 / blockSize);
+        pl.setRateInMilliseconds(25, sampleRate, 1.0 / controlBlockSize);
 }
 
 void Engine::updateLfoStorage()
@@ -93,26 +122,93 @@ void Engine::reassignLfos()
         lfos[i].setSampleRate(sampleRate, sampleRateInv);
         lfos[i].retrigger();
     }
+    if (poly)
+    {
+        for (auto &v : poly->voices)
+        {
+            for (int i = 0; i < numStepLFOs; ++i)
+            {
+                v.lfos[i].assign(&lfoStorage[i], patch.stepLfoNodes[i].rate, &transport, rng,
+                                 true);
+                v.lfos[i].setSampleRate(sampleRate, sampleRateInv);
+            }
+        }
+    }
 
     sendUpdateLfo();
 }
 
-void Engine::processControl(const clap_output_events_t *outq)
+void Engine::applyFilterControl(int f, const FilterControl &c)
 {
-    auto beatsPerMeasure = 4.0 * transport.signature.numerator / transport.signature.denominator;
+    liveFilter(f).concludeBlock();
 
-    processUIQueue(outq);
+    if (fadeActive[f])
+    {
+        fadingFilter(f).concludeBlock();
+        if (fadeBlocksLeft[f] == 0)
+        {
+            fadeActive[f] = false;
+        }
+        else
+        {
+            fadeBlocksLeft[f]--;
+            fadeLipol[f].newValue(1.f - (float)fadeBlocksLeft[f] / fadeBlocks[f]);
+        }
+    }
 
-    auto pos = patch.routingNode.oversample > 0.5;
-    if (pos != overSampling)
+    auto prep = [&](auto &flt, float morph)
     {
-        overSampling = pos;
-        hrUp.reset();
-        hrDn.reset();
-        setupFilter(0);
-        setupFilter(1);
+        flt.makeCoefficients(0, c.cutoff, c.resonance, morph);
+        flt.copyCoefficientsFromVoiceToVoice(0, 1);
+        flt.prepareBlock();
+    };
+    prep(liveFilter(f), c.morph);
+    if (fadeActive[f])
+        prep(fadingFilter(f), c.fadeMorph);
+}
+
+FilterControl Engine::filterControlFor(int f, const float *lfoOut, const float *mod,
+                                       float keyOffset) const
+{
+    auto &fn = patch.filterNodes[f];
+
+    float co = std::min((float)fn.cutoff + keyOffset + mod[modCutoff],
+                        (float)(maxCutoff * (overSampling + 1)));
+    float re = fn.resonance + mod[modResonance];
+    float mo = fn.morph + mod[modMorph];
+    for (int j = 0; j < numStepLFOs; ++j)
+    {
+        co += lfoOut[j] * patch.stepLfoNodes[j].toCO[f];
+        re += lfoOut[j] * patch.stepLfoNodes[j].toRes[f];
+        mo += lfoOut[j] * patch.stepLfoNodes[j].toMorph[f];
     }
 
+    auto fmo = [mo](auto model, const auto &config)
+    {
+        if (sst::filtersplusplus::Filter::coefficientsExtraIsBipolar(model, config, 0))
+            return mo * 2 - 1;
+        return mo;
+    };
+    return {co, re, fmo(fn.model, fn.config), fmo(fadeModel[f], fadeConfig[f])};
+}
+
+float Engine::panFor(int f, const float *lfoOut, const float *mod) const
+{
+    auto p = patch.filterNodes[f].pan + mod[modPan];
+    for (int j = 0; j < numStepLFOs; ++j)
+        p += lfoOut[j] * patch.stepLfoNodes[j].toPan[f];
+    return std::clamp(p * 0.5f + 0.5f, 0.f, 1.f);
+}
+
+void Engine::processControl(const clap_output_events_t *outq)
+{
+    TF_TRACE_SCOPE("audio", "Engine::processControl");
+    auto beatsPerMeasure = 4.0 * transport.signature.numerator / transport.signature.denominator;
+
+    pushRetireBacklog();
+    processUIQueue(outq);
+    updateRenderSetup();
+
     auto a0 = patch.filterNodes[0].active > 0.5;
     auto a1 = patch.filterNodes[1].active > 0.5;
 
@@ -128,6 +224,16 @@ void Engine::processControl(const clap_output_events_t *outq)
         setupFilter(1);
     }
 
+    for (int f = 0; f < (int)numFilters; ++f)
+    {
+        if (queuedFilterModel[f] && !fadeActive[f])
+        {
+            auto msg = *queuedFilterModel[f];
+            queuedFilterModel[f].reset();
+            setFilterModel(msg, queuedLoadFadeBlocks[f]);
+        }
+    }
+
     auto isPlaying = [](auto v)
     {
         auto b = (v & sst::basic_blocks::modulators::Transport::PLAYING) ||
@@ -146,7 +252,7 @@ void Engine::processControl(const clap_output_events_t *outq)
 
     lastStatus = transport.status;
 
-    auto btIncr = blockSize * transport.tempo / (60 * sampleRate);
+    auto btIncr = controlBlockSize * transport.tempo / (60 * sampleRate);
     transport.timeInBeats += btIncr;
 
     updateLfoStorage();
@@ -163,7 +269,7 @@ void Engine::processControl(const clap_output_events_t *outq)
     {
         if (freeRun)
         {
-            lfos[i].process(patch.stepLfoNodes[i].rate, 0, true, false, blockSize);
+            lfos[i].process(patch.stepLfoNodes[i].rate, 0, true, false, controlBlockSize);
         }
         else
         {
@@ -174,30 +280,21 @@ void Engine::processControl(const clap_output_events_t *outq)
         }
     }
 
+    float lfoOut[numStepLFOs];
+    for (int j = 0; j < numStepLFOs; ++j)
+        lfoOut[j] = lfos[j].output;
+
     for (int i = 0; i < numFilters; ++i)
     {
-        filters[i].concludeBlock();
-
-        auto &fn = patch.filterNodes[i];
-        auto &sn = patch.stepLfoNodes[i];
-
-        float co = std::min((float)fn.cutoff, (float)(maxCutoff * (overSampling + 1)));
-        float re = fn.resonance;
-        float mo = fn.morph;
-        for (int j = 0; j < numStepLFOs; ++j)
-        {
-            co += lfos[j].output * patch.stepLfoNodes[j].toCO[i];
-            re += lfos[j].output * patch.stepLfoNodes[j].toRes[i];
-            mo += lfos[j].output * patch.stepLfoNodes[j].toMorph[i];
-        }
-        if (sst::filtersplusplus::Filter::coefficientsExtraIsBipolar(fn.model, fn.config, 0))
-            mo = mo * 2 - 1;
-
-        filters[i].makeCoefficients(0, co, re, mo);
-        filters[i].copyCoefficientsFromVoiceToVoice(0, 1);
-        filters[i].prepareBlock();
+        filterControl[i] = filterControlFor(i, lfoOut, paramMod[i], 0.f);
+        if (!deferFilterControl)
+            applyFilterControl(i, filterControl[i]);
     }
 
+    if (patch.routingNode.noisePower > 0.5)
+        noise.fill(filterBlockSamples());
+    noisePos = 0;
+
     auto mode = (RoutingModes)(int)patch.routingNode.routingMode;
 
     if (mode == RoutingModes::Serial)
@@ -220,20 +317,25 @@ void Engine::processControl(const clap_output_events_t *outq)
         blendLipol2.newValue(sqrt(bv) * 1.4142135);
     }
 
-    auto p1 = patch.filterNodes[0].pan + lfos[0].output * patch.stepLfoNodes[0].toPan[0] +
-              lfos[1].output * patch.stepLfoNodes[1].toPan[0];
-    auto p2 = patch.filterNodes[1].pan + lfos[0].output * patch.stepLfoNodes[0].toPan[1] +
-              lfos[1].output * patch.stepLfoNodes[1].toPan[1];
-    p1 = std::clamp(p1 * 0.5f + 0.5f, 0.f, 1.f);
-    p2 = std::clamp(p2 * 0.5f + 0.5f, 0.f, 1.f);
+    auto p1 = panFor(0, lfoOut, paramMod[0]);
+    auto p2 = panFor(1, lfoOut, paramMod[1]);
     panLag[0].setTarget(p1);
     panLag[1].setTarget(p2);
+    if (renderStarting)
+    {
+        panLag[0].snapToTarget();
+        panLag[1].snapToTarget();
+    }
     sst::basic_blocks::dsp::pan_laws::stereoEqualPower(panLag[0].getValue(), panMatrix[0]);
     sst::basic_blocks::dsp::pan_laws::stereoEqualPower(panLag[1].getValue(), panMatrix[1]);
     panLag[0].process();
     panLag[1].process();
 
     useFeedback = patch.routingNode.feedbackPower > 0.5;
+    polyMode = poly && patch.routingNode.polyphony > 0.5;
+    keytrack = patch.routingNode.keytrack;
+    setEcoFeedback(useFeedback && patch.routingNode.feedbackEco > 0.5 && !polyMode);
+    ecoPos = 0;
 
     float inG = patch.routingNode.inputGain + lfos[0].output * patch.stepLfoNodes[0].toPreG +
                 lfos[1].output * patch.stepLfoNodes[1].toPreG;
@@ -267,6 +369,18 @@ void Engine::processControl(const clap_output_events_t *outq)
     outG = outG * outG * outG;
     outGainLipol.newValue(outG);
 
+    // A render doesn't glide in from whatever played before it
+    if (renderStarting)
+    {
+        for (auto *l : {&blendLipol1, &blendLipol2, &inGainLipol, &outGainLipol, &noiseGainLipol,
+                        &fbLevelLipol, &mixLipol})
+            l->instantize();
+        renderStarting = false;
+    }
+
+    if (poly)
+        processPolyControl(outq);
+
     for (auto it = paramLagSet.begin(); it != paramLagSet.end();)
     {
         it->lag.process();
@@ -283,14 +397,28 @@ void Engine::processControl(const clap_output_events_t *outq)
 
     lagHandler.process();
 
+    meterThisBlock = editorActive.load(std::memory_order_relaxed) &&
+                     (!lowTelemetry || (meterBlockCount++ & 3) == 0);
     if (editorActive.load(std::memory_order_relaxed))
     {
-        if (lastVuUpdate >= updateVuEvery)
+        auto vuEvery = updateVuEvery * (int32_t)blockSize / (int32_t)controlBlockSize;
+        if (lastVuUpdate >= vuEvery * (lowTelemetry ? 4 : 1))
         {
-            AudioToMainMsg msg{AudioToMainMsg::UPDATE_VU, 0, vuPeak.vu_peak[0], vuPeak.vu_peak[1]};
-            audioToMain.push(msg);
+            if (vuPeak.vu_peak[0] != lastSentVu[0] || vuPeak.vu_peak[1] != lastSentVu[1])
+            {
+                lastSentVu[0] = vuPeak.vu_peak[0];
+                lastSentVu[1] = vuPeak.vu_peak[1];
+                pushToMain({AudioToMainMsg::UPDATE_VU, 0, lastSentVu[0], lastSentVu[1]});
+            }
 
             sendUpdateLfo();
+#if TWOFILTERS_DSP_TIMING
+            if (++vuUpdatesSinceTimingReport >= vuUpdatesPerTimingReport)
+            {
+                vuUpdatesSinceTimingReport = 0;
+                sendDspTiming();
+            }
+#endif
 
             lastVuUpdate = 0;
         }
@@ -301,8 +429,54 @@ void Engine::processControl(const clap_output_events_t *outq)
     }
 }
 
+void Engine::updateRenderSetup()
+{
+    if (renderModeChanging())
+    {
+        renderingOffline = !renderingOffline;
+        renderStarting = renderingOffline;
+        if (renderStarting)
+            startOfflineRender();
+    }
+    renderBoost = renderBoostFor(patch, renderingOffline);
+
+    // Offline there is no real time to keep up with
+    cpuGovernorOn = patch.routingNode.cpuGovernor > 0.5 && !renderingOffline;
+    applyGovernedLevel();
+    setControlBlockSize(renderBoost ? renderControlBlockSize
+                                    : blockSize * (coarseControl ? 2 : 1));
+
+    auto pos = (patch.routingNode.oversample > 0.5 || renderBoost) &&
+               appliedGovernorLevel < CpuGovernor::NoOversampling;
+    auto plp = patch.routingNode.oversamplePhase > 0.5;
+    if (pos != overSampling || plp != linearPhase)
+    {
+        flushParallel();
+        hrUp.reset();
+        hrDn.reset();
+        lpUp.reset();
+        lpDn.reset();
+        linearPhase = plp;
+        if (pos != overSampling)
+        {
+            overSampling = pos;
+            setupFilter(0);
+            setupFilter(1);
+        }
+    }
+
+    // Latency may only change across a restart, so ask for one; the host then re-reads it.
+    // Until then, and for a bounce, the output is padded up to what the host was told.
+    if (clapHost && !latencyRestartRequested && latencyFor(patch) != reportedLatency)
+    {
+        latencyRestartRequested = true;
+        clapHost->request_restart(clapHost);
+    }
+}
+
 void Engine::processUIQueue(const clap_output_events_t *outq)
 {
+    TF_TRACE_SCOPE("audio", "Engine::processUIQueue");
     auto uiM = mainToAudio.pop();
     while (uiM.has_value())
     {
@@ -311,8 +485,14 @@ void Engine::processUIQueue(const clap_output_events_t *outq)
         case MainToAudioMsg::REQUEST_NON_PATCH_STATE:
         {
             // The editor reads all patch state straight from patchMain; it only needs the
-            // engine-owned bits echoed back. Today that is just the sample rate.
-            audioToMain.push({AudioToMainMsg::SEND_SAMPLE_RATE, 0, (float)sampleRate});
+            // engine-owned bits echoed back: the sample rate and CPU governor level. A newly
+            // opened editor has no VU or LFO state either, so resend those on the next tick.
+            pushToMain({AudioToMainMsg::SEND_SAMPLE_RATE, 0, (float)sampleRate});
+            pushToMain(
+                {AudioToMainMsg::UPDATE_CPU_GOVERNOR, appliedGovernorLevel, cpuGovernor.load});
+            lastSentVu[0] = lastSentVu[1] = -1.f;
+            for (auto &l : lastSentLfo)
+                l[0] = l[1] = -1.f;
         }
         break;
         case MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING:
@@ -399,11 +579,13 @@ void Engine::processUIQueue(const clap_output_events_t *outq)
         {
             if (lagHandler.active)
                 lagHandler.instantlySnap();
+            flushParallel();
             audioRunning = false;
         }
         break;
         case MainToAudioMsg::START_AUDIO:
         {
+            flushParallel();
             audioRunning = true;
         }
         break;
@@ -414,14 +596,43 @@ void Engine::processUIQueue(const clap_output_events_t *outq)
         break;
         case MainToAudioMsg::SET_FILTER_MODEL:
         {
-            auto &fn = patch.filterNodes[uiM->paramId];
-            fn.model = (sst::filtersplusplus::FilterModel)uiM->uintValues[0];
-            fn.config.pt = (sst::filtersplusplus::Passband)uiM->uintValues[1];
-            fn.config.st = (sst::filtersplusplus::Slope)uiM->uintValues[2];
-            fn.config.dt = (sst::filtersplusplus::DriveMode)uiM->uintValues[3];
-            fn.config.mt = (sst::filtersplusplus::FilterSubModel)uiM->uintValues[4];
-
-            setupFilter(uiM->paramId);
+            setFilterModel(*uiM, transitionLoadActive ? transitionBlocks : 0);
+        }
+        break;
+        case MainToAudioMsg::BEGIN_TRANSITION_LOAD:
+        {
+            if (lagHandler.active)
+                lagHandler.instantlySnap();
+            // Milliseconds in, blocks of the control rate running now out
+            auto blocks = std::ceil((double)uiM->uintValues[0] * sampleRate /
+                                    (1000.0 * controlBlockSize));
+            transitionBlocks = std::max((int32_t)blocks, (int32_t)1);
+            transitionLoadActive = true;
+        }
+        break;
+        case MainToAudioMsg::SET_PARAM_FOR_TRANSITION:
+        {
+            // Ride the same lags host automation uses rather than jumping. Discrete and
+            // unsmoothed values (modes, step counts, rates) still land immediately.
+            auto dest = patch.paramMap.at(uiM->paramId);
+            if (dest->meta.type == md_t::FLOAT &&
+                (dest->adhocFeatures & Param::AdHocFeatureValues::DONT_SMOOTH) == 0)
+            {
+                if (!dest->lag.isActive())
+                    dest->lag.snapTo(dest->value);
+                dest->lag.setTarget(uiM->value);
+                paramLagSet.addToActive(dest);
+            }
+            else
+            {
+                dest->value = uiM->value;
+            }
+        }
+        break;
+        case MainToAudioMsg::END_TRANSITION_LOAD:
+        {
+            // No postLoad: the lags finish the move and the LFOs keep running in phase.
+            transitionLoadActive = false;
         }
         break;
         }
@@ -429,6 +640,48 @@ void Engine::processUIQueue(const clap_output_events_t *outq)
     }
 }
 
+void Engine::setFilterModel(const MainToAudioMsg &msg, int32_t loadFadeBlocks)
+{
+    auto f = (int)msg.paramId;
+    if (fadeActive[f])
+    {
+        queuedFilterModel[f] = msg;
+        queuedLoadFadeBlocks[f] = loadFadeBlocks;
+        return;
+    }
+
+    auto &fn = patch.filterNodes[f];
+    auto priorModel = fn.model;
+    auto priorConfig = fn.config;
+    fn.model = (sst::filtersplusplus::FilterModel)msg.uintValues[0];
+    fn.config.pt = (sst::filtersplusplus::Passband)msg.uintValues[1];
+    fn.config.st = (sst::filtersplusplus::Slope)msg.uintValues[2];
+    fn.config.dt = (sst::filtersplusplus::DriveMode)msg.uintValues[3];
+    fn.config.mt = (sst::filtersplusplus::FilterSubModel)msg.uintValues[4];
+
+    auto changed = fn.model != priorModel || fn.config.pt != priorConfig.pt ||
+                   fn.config.st != priorConfig.st || fn.config.dt != priorConfig.dt ||
+                   fn.config.mt != priorConfig.mt;
+    auto *prepared = takeStandbyFilter(f);
+    if (changed && (loadFadeBlocks > 0 || prepared))
+    {
+        fadeModel[f] = priorModel;
+        fadeConfig[f] = priorConfig;
+        auto blocks = loadFadeBlocks > 0
+                          ? loadFadeBlocks
+                          : (int32_t)std::ceil(modelSwapSeconds * sampleRate / controlBlockSize);
+        crossfadeToFilterModel(f, std::max(blocks, (int32_t)1), prepared);
+    }
+    else
+    {
+        if (prepared)
+            retireFilter(prepared);
+        if (loadFadeBlocks == 0)
+            setupFilter(f);
+        // else: same filter, so keep its state and let the new coefficients glide
+    }
+}
+
 void Engine::handleParamValue(Param *p, uint32_t pid, float value)
 {
     if (!p)
@@ -440,8 +693,7 @@ void Engine::handleParamValue(Param *p, uint32_t pid, float value)
     p->lag.setTarget(value);
     paramLagSet.addToActive(p);
 
-    AudioToMainMsg au = {AudioToMainMsg::UPDATE_PARAM, pid, value};
-    audioToMain.push(au);
+    pushToMain({AudioToMainMsg::UPDATE_PARAM, pid, value});
 
     // If no editor is open to drain audioToMain, ask the main thread to drain it into
     // patchMain. Coalesce so we schedule at most one callback per pending drain.
@@ -454,6 +706,8 @@ void Engine::handleParamValue(Param *p, uint32_t pid, float value)
 
 void Engine::onMainThread()
 {
+    collectRetiredFilters();
+
     // When no editor is open, this callback owns draining audioToMain into patchMain so
     // that host-driven param changes stay reflected in the main-thread source of truth.
     if (!editorActive.load(std::memory_order_relaxed))
@@ -465,7 +719,48 @@ void Engine::onMainThread()
 
 void Engine::setupFilter(int f)
 {
-    memset(combDelays[f], 0, sizeof(combDelays[f]));
+    TF_TRACE_SCOPE("audio", "Engine::setupFilter");
+    fadeActive[f] = false;
+    setupFilterSlot(liveSlot[f], f);
+    fbL = 0;
+    fbR = 0;
+    fb2L = 0;
+    fb2R = 0;
+    memset(ecoFb, 0, sizeof(ecoFb));
+    setupPolyFilter(f);
+}
+
+void Engine::setEcoFeedback(bool on)
+{
+    if (on == ecoFeedback)
+        return;
+
+    if (on)
+    {
+        // Hold the current loop values for the first block
+        std::fill(std::begin(ecoFb[0][0]), std::end(ecoFb[0][0]), fbL);
+        std::fill(std::begin(ecoFb[0][1]), std::end(ecoFb[0][1]), fbR);
+        std::fill(std::begin(ecoFb[1][0]), std::end(ecoFb[1][0]), fb2L);
+        std::fill(std::begin(ecoFb[1][1]), std::end(ecoFb[1][1]), fb2R);
+    }
+    else
+    {
+        // Carry on from the last sample written
+        auto last = filterBlockSamples() - 1;
+        fbL = ecoFb[0][0][last];
+        fbR = ecoFb[0][1][last];
+        fb2L = ecoFb[1][0][last];
+        fb2R = ecoFb[1][1][last];
+    }
+    ecoFeedback = on;
+}
+
+void Engine::setupFilterSlot(int slot, int f)
+{
+    flushParallel();
+
+    auto &unit = *filterSlots[slot][f];
+    memset(unit.delays, 0, sizeof(unit.delays));
     auto &fn = patch.filterNodes[f];
 
     auto model = fn.model;
@@ -477,20 +772,623 @@ void Engine::setupFilter(int f)
         cfg = {};
     }
 
-    auto osf = overSampling ? 2 : 1;
-    filters[f].setFilterModel(model);
-    filters[f].setModelConfiguration(cfg);
-    filters[f].setStereo();
-    filters[f].setSampleRateAndBlockSize(osf * sampleRate, osf * blockSize);
-    for (int i = 0; i < 4; ++i)
-        filters[f].provideDelayLine(i, combDelays[f][i]);
-    if (!filters[f].prepareInstance())
-        SQLOG("Failed to prepare filter instance");
-    filters[f].reset();
-    fbL = 0;
-    fbR = 0;
-    fb2L = 0;
-    fb2R = 0;
+    configureFilter(unit.filter, model, cfg, unit.delays);
+}
+
+void Engine::configureFilter(sst::filtersplusplus::Filter &flt,
+                             sst::filtersplusplus::FilterModel model,
+                             const sst::filtersplusplus::ModelConfig &cfg, combDelay_t *delays,
+                             bool quad)
+{
+    auto rate = (overSampling ? 2 : 1) * sampleRate;
+    filterSampleRate.store(rate, std::memory_order_relaxed);
+    filterBlockSize.store(filterBlockSamples(), std::memory_order_relaxed);
+    configureFilter(flt, model, cfg, delays, rate, filterBlockSamples(), quad);
+}
+
+void Engine::configureFilter(sst::filtersplusplus::Filter &flt,
+                             sst::filtersplusplus::FilterModel model,
+                             const sst::filtersplusplus::ModelConfig &cfg, combDelay_t *delays,
+                             double sampleRate, uint32_t blockSamples, bool quad)
+{
+    // In the core, so the filter runs that level's kernels
+    engineCore().configureFilter(flt, model, cfg, delays, sampleRate, blockSamples, quad);
+}
+
+void Engine::setupPolyVoices()
+{
+    if (!poly)
+        poly = std::make_unique<PolyVoices>(*this);
+}
+
+void Engine::setupPolyFilter(int f)
+{
+    if (!poly)
+        return;
+
+    polyFilterStale[f] = false;
+    auto &fn = patch.filterNodes[f];
+    auto model = activeFilter[f] ? fn.model : sst::filtersplusplus::FilterModel::None;
+    auto cfg = activeFilter[f] ? fn.config : sst::filtersplusplus::ModelConfig{};
+    for (int p = 0; p < PolyVoices::numPacks; ++p)
+    {
+        memset(poly->combDelays[p][f], 0, sizeof(poly->combDelays[p][f]));
+        configureFilter(poly->filters[p][f], model, cfg, poly->combDelays[p][f], true);
+    }
+}
+
+void Engine::polyNoteOn(int16_t port, int16_t channel, int16_t key, int32_t noteId)
+{
+    if (!polyMode)
+        return;
+    poly->voiceManager.processNoteOnEvent(port, channel, key, noteId, 1.f, 0.f);
+}
+
+void Engine::polyNoteOff(int16_t port, int16_t channel, int16_t key, int32_t noteId)
+{
+    if (!poly)
+        return;
+    poly->voiceManager.processNoteOffEvent(port, channel, key, noteId, 0.f);
+}
+
+void Engine::polyNoteChoke(int16_t port, int16_t channel, int16_t key, int32_t noteId)
+{
+    if (!poly)
+        return;
+    for (int v = 0; v < PolyVoices::numSlots; ++v)
+        if (poly->voices[v].active && poly->voices[v].matches(port, channel, key, noteId))
+            endPolyVoice(v);
+}
+
+int Engine::startPolyVoice(int16_t port, int16_t channel, int16_t key, int32_t noteId)
+{
+    auto &pv = *poly;
+    auto v = pv.freeVoice();
+    if (v < 0)
+        return v;
+
+    // A pack resets as a whole, so only when the other lanes are quiet
+    auto pack = PolyVoices::packOf(v);
+    if (!pv.packActive(pack))
+    {
+        for (auto &flt : pv.filters[pack])
+            flt.reset();
+    }
+
+    auto &voice = pv.voices[v];
+    voice.active = true;
+    voice.gateOn = true;
+    voice.port = port;
+    voice.channel = channel;
+    voice.key = key;
+    voice.noteId = noteId;
+    voice.gateLevel = 0;
+    voice.gate.newValue(0.f);
+    voice.gate.instantize();
+    voice.fb = 0;
+    voice.fb2 = 0;
+    voice.settleBlocks = 0;
+    memset(voice.mod, 0, sizeof(voice.mod));
+    for (auto &l : voice.lfos)
+        l.retrigger();
+    return v;
+}
+
+void Engine::endPolyVoice(int v)
+{
+    auto &pv = *poly;
+    auto &voice = pv.voices[v];
+    voice.active = false;
+    voice.gateOn = false;
+    voice.settleBlocks =
+        (uint32_t)std::ceil(PolyVoices::settleSeconds * sampleRate / controlBlockSize);
+    if (pv.numPendingEnds < pv.pendingEnds.size())
+        pv.pendingEnds[pv.numPendingEnds++] = {voice.port, voice.channel, voice.key,
+                                               voice.noteId};
+    pv.responder.voiceEndCallback(&voice);
+}
+
+bool Engine::polyModTargetFor(uint32_t pid, int &f, int &t) const
+{
+    for (int i = 0; i < numFilters; ++i)
+    {
+        auto &fn = patch.filterNodes[i];
+        const Param *targets[numPolyModTargets]{&fn.cutoff, &fn.resonance, &fn.morph, &fn.pan};
+        for (int j = 0; j < numPolyModTargets; ++j)
+        {
+            if (targets[j]->meta.id == pid)
+            {
+                f = i;
+                t = j;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Engine::paramModulation(uint32_t pid, int16_t port, int16_t channel, int16_t key,
+                             int32_t noteId, float amount)
+{
+    int f{-1}, t{-1};
+    if (!polyModTargetFor(pid, f, t))
+        return;
+
+    if (noteId == -1 && port == -1 && channel == -1 && key == -1)
+    {
+        paramMod[f][t] = amount;
+        return;
+    }
+
+    if (!poly)
+        return;
+    poly->voiceManager.routePolyphonicParameterModulation(port, channel, key, noteId, pid,
+                                                          amount);
+}
+
+int32_t PolyVoices::VMResponder::beginVoiceCreationTransaction(beginBuffer_t &buffer, uint16_t,
+                                                               uint16_t, uint16_t, int32_t,
+                                                               float)
+{
+    // One voice a note, all in the one polyphony group
+    buffer[0].polyphonyGroup = 0;
+    return 1;
+}
+
+int32_t PolyVoices::VMResponder::initializeMultipleVoices(int32_t voiceCount,
+                                                          const initInstructions_t &instructions,
+                                                          initBuffer_t &working, uint16_t port,
+                                                          uint16_t channel, uint16_t key,
+                                                          int32_t noteId, float, float)
+{
+    using instr_t = sst::voicemanager::VoiceInitInstructionsEntry<VMConfig>::Instruction;
+    int32_t started{0};
+    for (int32_t i = 0; i < voiceCount; ++i)
+    {
+        working[i].voice = nullptr;
+        if (instructions[i].instruction == instr_t::SKIP)
+            continue;
+        auto v = engine.startPolyVoice(port, channel, key, noteId);
+        if (v < 0)
+            continue;
+        working[i].voice = &engine.poly->voices[v];
+        started++;
+    }
+    return started;
+}
+
+void PolyVoices::VMResponder::terminateVoice(PolyVoice *v)
+{
+    if (v->active)
+        engine.endPolyVoice(engine.poly->indexOf(v));
+}
+
+void PolyVoices::VMResponder::retriggerVoiceWithNewNoteID(PolyVoice *v, int32_t noteId, float)
+{
+    v->noteId = noteId;
+    v->gateOn = true;
+}
+
+void PolyVoices::VMResponder::moveVoice(PolyVoice *v, uint16_t port, uint16_t channel,
+                                        uint16_t key, float)
+{
+    v->port = port;
+    v->channel = channel;
+    v->key = key;
+}
+
+void PolyVoices::VMResponder::moveAndRetriggerVoice(PolyVoice *v, uint16_t port,
+                                                    uint16_t channel, uint16_t key,
+                                                    float velocity)
+{
+    moveVoice(v, port, channel, key, velocity);
+    v->gateOn = true;
+    for (auto &l : v->lfos)
+        l.retrigger();
+}
+
+void PolyVoices::VMResponder::setVoicePolyphonicParameterModulation(PolyVoice *v,
+                                                                    uint32_t parameter,
+                                                                    double value)
+{
+    int f, t;
+    if (engine.polyModTargetFor(parameter, f, t))
+        v->mod[f][t] = (float)value;
+}
+
+void Engine::processPolyControl(const clap_output_events_t *outq)
+{
+    TF_TRACE_SCOPE("audio", "Engine::processPolyControl");
+    auto &pv = *poly;
+
+    if (polyMode)
+    {
+        for (int f = 0; f < numFilters; ++f)
+            if (polyFilterStale[f])
+                setupPolyFilter(f);
+    }
+
+    // Gates ramp a block at a time; a released voice ends once its ramp has reached zero
+    auto gateStep = (float)(controlBlockSize / (PolyVoices::gateSeconds * sampleRate));
+    for (int v = 0; v < PolyVoices::numSlots; ++v)
+    {
+        auto &voice = pv.voices[v];
+        if (!voice.active)
+        {
+            if (voice.settleBlocks > 0)
+                voice.settleBlocks--;
+            continue;
+        }
+        if (!polyMode || (!voice.gateOn && voice.gateLevel <= 0.f))
+        {
+            endPolyVoice(v);
+            continue;
+        }
+        voice.gateLevel = std::clamp(voice.gateLevel + (voice.gateOn ? gateStep : -gateStep),
+                                     0.f, 1.f);
+        voice.gate.newValue(voice.gateLevel);
+    }
+
+    for (int p = 0; p < PolyVoices::numPacks; ++p)
+    {
+        if (!pv.packActive(p))
+            continue;
+
+        for (auto &flt : pv.filters[p])
+            flt.concludeBlock();
+
+        bool idle[PolyVoices::lanes]{};
+        for (int l = 0; l < PolyVoices::lanes; ++l)
+        {
+            auto &voice = pv.voices[p * PolyVoices::lanes + l];
+            if (!voice.active)
+            {
+                idle[l] = true;
+                continue;
+            }
+
+            float lfoOut[numStepLFOs];
+            for (int j = 0; j < numStepLFOs; ++j)
+            {
+                voice.lfos[j].process(patch.stepLfoNodes[j].rate, 0, true, false,
+                                      controlBlockSize);
+                lfoOut[j] = voice.lfos[j].output;
+            }
+
+            auto keyOffset = keytrack * (voice.key - 60);
+            for (int f = 0; f < numFilters; ++f)
+            {
+                float mod[numPolyModTargets];
+                for (int t = 0; t < numPolyModTargets; ++t)
+                    mod[t] = paramMod[f][t] + voice.mod[f][t];
+
+                auto c = filterControlFor(f, lfoOut, mod, keyOffset);
+                pv.filters[p][f].makeCoefficients(l, c.cutoff, c.resonance, c.morph);
+                sst::basic_blocks::dsp::pan_laws::stereoEqualPower(panFor(f, lfoOut, mod),
+                                                                   voice.pan[f]);
+            }
+        }
+
+        // Free lanes get an unresonant filter at 440Hz, so whatever they held dies away
+        for (auto &flt : pv.filters[p])
+        {
+            int damped{-1};
+            for (int l = 0; l < PolyVoices::lanes; ++l)
+            {
+                if (!idle[l])
+                    continue;
+                if (damped < 0)
+                {
+                    flt.makeCoefficients(l, 0.f, 0.f, 0.f);
+                    damped = l;
+                }
+                else
+                {
+                    flt.copyCoefficientsFromVoiceToVoice(damped, l);
+                }
+            }
+            flt.prepareBlock();
+        }
+    }
+
+    if (outq)
+    {
+        for (uint32_t i = 0; i < pv.numPendingEnds; ++i)
+        {
+            auto &e = pv.pendingEnds[i];
+            clap_event_note_t n;
+            n.header.size = sizeof(clap_event_note_t);
+            n.header.time = 0;
+            n.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+            n.header.type = CLAP_EVENT_NOTE_END;
+            n.header.flags = 0;
+            n.note_id = e.noteId;
+            n.port_index = e.port;
+            n.channel = e.channel;
+            n.key = e.key;
+            n.velocity = 0;
+            outq->try_push(outq, &n.header);
+        }
+    }
+    pv.numPendingEnds = 0;
+}
+
+void Engine::crossfadeToFilterModel(int f, int32_t blocks, FilterUnit *prepared)
+{
+    // The outgoing filter keeps its state and becomes the fading slot; the new model starts
+    // clean in the other slot. Feedback is left alone so the loop doesn't collapse either.
+    // Only called with no fade running; setFilterModel holds a later change until then.
+    auto next = 1 - liveSlot[f];
+    if (prepared)
+    {
+        flushParallel();
+        retireFilter(filterSlots[next][f].release());
+        filterSlots[next][f].reset(prepared);
+    }
+    else
+    {
+        setupFilterSlot(next, f);
+    }
+    liveSlot[f] = next;
+    polyFilterStale[f] = true; // voices are short, so they just change over
+
+    fadeActive[f] = true;
+    fadeBlocks[f] = blocks;
+    fadeBlocksLeft[f] = blocks;
+    fadeLipol[f].newValue(0.f);
+    fadeLipol[f].instantize();
+}
+
+void Engine::prepareStandbyFilter(int f)
+{
+    collectRetiredFilters();
+
+    // Not activated yet: the first setup is the audio thread's anyway
+    auto sr = filterSampleRate.load(std::memory_order_relaxed);
+    if (sr <= 0)
+        return;
+
+    auto &fn = patchMain.filterNodes[f];
+    auto unit = std::make_unique<FilterUnit>();
+    if (fn.active > 0.5)
+    {
+        unit->model = fn.model;
+        unit->config = fn.config;
+    }
+    unit->sampleRate = sr;
+    unit->blockSamples = filterBlockSize.load(std::memory_order_relaxed);
+    configureFilter(unit->filter, unit->model, unit->config, unit->delays, unit->sampleRate,
+                    unit->blockSamples);
+
+    // One the audio thread never took is still ours
+    delete standbyFilter[f].exchange(unit.release(), std::memory_order_acq_rel);
+}
+
+uint32_t Engine::collectRetiredFilters()
+{
+    uint32_t res{0};
+    auto u = retiredFilters.pop();
+    while (u.has_value())
+    {
+        delete *u;
+        res++;
+        u = retiredFilters.pop();
+    }
+    return res;
+}
+
+FilterUnit *Engine::takeStandbyFilter(int f)
+{
+    auto *u = standbyFilter[f].exchange(nullptr, std::memory_order_acq_rel);
+    if (!u)
+        return nullptr;
+
+    auto &fn = patch.filterNodes[f];
+    auto model = activeFilter[f] ? fn.model : sst::filtersplusplus::FilterModel::None;
+    auto cfg = activeFilter[f] ? fn.config : sst::filtersplusplus::ModelConfig{};
+    if (u->preparedFor(model, cfg, (overSampling ? 2 : 1) * sampleRate, filterBlockSamples()))
+        return u;
+
+    retireFilter(u);
+    return nullptr;
+}
+
+void Engine::retireFilter(FilterUnit *u)
+{
+    if (!u)
+        return;
+    if (!retiredFilters.push(u))
+    {
+        u->nextRetired = retireBacklog;
+        retireBacklog = u;
+    }
+}
+
+void Engine::pushRetireBacklog()
+{
+    while (retireBacklog)
+    {
+        auto *next = retireBacklog->nextRetired;
+        if (!retiredFilters.push(retireBacklog))
+            return;
+        retireBacklog->nextRetired = nullptr;
+        retireBacklog = next;
+    }
+}
+
+bool Engine::governorRebuilds(uint32_t from, uint32_t to) const
+{
+    auto crosses = [from, to](uint32_t l) { return (from >= l) != (to >= l); };
+    auto os = patch.routingNode.oversample > 0.5;
+    return (os && crosses(CpuGovernor::NoOversampling)) || crosses(CpuGovernor::CoarseControl);
+}
+
+void Engine::governorEndProcess(float *outL, float *outR, uint32_t frames, double seconds)
+{
+    auto &g = cpuGovernor;
+    auto running = runningLatency();
+    if (!cpuGovernorOn && governedLevel == CpuGovernor::Full &&
+        appliedGovernorLevel == CpuGovernor::Full && g.outputIdle() &&
+        running == reportedLatency)
+        return;
+
+    // Make up what running without oversampling takes off the latency the host was told:
+    // under the governor, which only switches while the output is silent, and in realtime
+    // for a patch whose bounces oversample. A render mode change sets up before the buffer.
+    g.setPad(reportedLatency > running ? reportedLatency - running : 0);
+    g.processOutput(outL, outR, frames);
+
+    if (cpuGovernorOn)
+        g.record(seconds, frames);
+
+    // Switching the filters' rate or block is a reset, so fade out, switch silent, fade in
+    auto want = cpuGovernorOn ? g.target : (uint32_t)CpuGovernor::Full;
+    if (want != governedLevel)
+    {
+        if (!governorRebuilds(governedLevel, want) || g.gain == 0.f)
+            governedLevel = want;
+        else
+            g.gainTarget = 0.f;
+    }
+    else if (appliedGovernorLevel == governedLevel)
+    {
+        g.gainTarget = 1.f;
+    }
+}
+
+void Engine::applyGovernedLevel()
+{
+    if (appliedGovernorLevel == governedLevel)
+        return;
+
+    appliedGovernorLevel = governedLevel;
+    lowTelemetry = appliedGovernorLevel >= CpuGovernor::LowTelemetry;
+    coarseControl = appliedGovernorLevel >= CpuGovernor::CoarseControl;
+    // The control block size and oversampling follow in processControl
+
+    // An editor opened later asks for it with the rest of the non patch state
+    if (editorActive.load(std::memory_order_relaxed))
+        pushToMain({AudioToMainMsg::UPDATE_CPU_GOVERNOR, appliedGovernorLevel, cpuGovernor.load});
+}
+
+uint32_t Engine::latencyFor(const Patch &p)
+{
+    if (p.routingNode.oversample < 0.5 && p.routingNode.offlineQuality < 0.5)
+        return 0;
+    if (p.routingNode.oversamplePhase > 0.5)
+        return LinearPhaseHalfBand::latency;
+    return iirOversamplingLatency();
+}
+
+uint32_t Engine::runningLatency() const
+{
+    if (!overSampling)
+        return 0;
+    return linearPhase ? LinearPhaseHalfBand::latency : iirOversamplingLatency();
+}
+
+void Engine::setControlBlockSize(uint32_t n)
+{
+    if (n == controlBlockSize)
+        return;
+
+    controlBlockSize = n;
+    lipolStep[0] = (float)blockSize / n;
+    lipolStep[1] = (float)blockSize / (2 * n);
+
+    // The same glide times, stepped at the new rate
+    for (auto &[i, p] : patch.paramMap)
+        p->lag.setRateInMilliseconds(1000.0 * 64.0 / 48000.0, sampleRate, 1.0 / n);
+    for (auto &pl : panLag)
+        pl.setRateInMilliseconds(25, sampleRate, 1.0 / n);
+
+    setupFilter(0);
+    setupFilter(1);
+}
+
+void Engine::startOfflineRender()
+{
+    // Whatever ran before a bounce must not reach into it: the same seeds, no glides or
+    // voices in flight, and every filter, oversampler and loop empty
+    flushParallel();
+    noise.seed(renderSeed);
+    rng.reseed((uint32_t)renderSeed);
+
+    if (lagHandler.active)
+        lagHandler.instantlySnap();
+    snapAllParams();
+    restartLfos();
+
+    cpuGovernor.reset();
+    governedLevel = CpuGovernor::Full;
+
+    if (poly)
+    {
+        for (int v = 0; v < PolyVoices::numSlots; ++v)
+            if (poly->voices[v].active)
+                endPolyVoice(v);
+    }
+
+    hrUp.reset();
+    hrDn.reset();
+    lpUp.reset();
+    lpDn.reset();
+    monoBlock = false;
+    stereoBlockSymmetric = false;
+    setupFilter(0);
+    setupFilter(1);
+}
+
+uint32_t Engine::iirOversamplingLatency()
+{
+    // The centre of mass of the up / down pair's impulse response, which is its group
+    // delay at DC. Measured once rather than derived from the allpass coefficients.
+    static const uint32_t latency = []()
+    {
+        sst::filters::HalfRate::HalfRateFilter up{6, true}, dn{6, true};
+        double moment{0}, sum{0};
+        for (int n = 0; n < 1024; ++n)
+        {
+            float in = n == 0 ? 1.f : 0.f;
+            float uL[2], uR[2], oL, oR;
+            up.process_sample_U2(in, in, uL, uR);
+            dn.process_sample_D2(uL, uR, oL, oR);
+            moment += n * oL;
+            sum += oL;
+        }
+        return (uint32_t)std::max(std::round(moment / sum), 0.0);
+    }();
+    return latency;
+}
+
+void Engine::setupParallelRender()
+{
+    hostThreadPool = nullptr;
+    if (clapHost)
+        hostThreadPool = static_cast<const clap_host_thread_pool_t *>(
+            clapHost->get_extension(clapHost, CLAP_EXT_THREAD_POOL));
+
+    if (hostThreadPool && !parallelRender)
+        parallelRender = std::make_unique<ParallelRender>();
+}
+
+void Engine::flushParallel()
+{
+    if (!parallelRender || parallelRender->samples == 0)
+        return;
+
+    TF_TRACE_SCOPE("audio", "Engine::flushParallel");
+    auto &pr = *parallelRender;
+    // request_exec returns once every task has run. If the host can't take the work right
+    // now (or we are the pool's own thread) run the two tasks here, in order.
+    if (!hostThreadPool || !hostThreadPool->request_exec(clapHost, numFilters))
+    {
+        for (uint32_t f = 0; f < numFilters; ++f)
+            runParallelTask(f);
+    }
+    (this->*parallelJoin)();
+    pr.samples = 0;
+    pr.numPlans = 0;
 }
 
 void Engine::restartLfos()
@@ -502,14 +1400,38 @@ void Engine::restartLfos()
 
 void Engine::sendUpdateLfo()
 {
-    audioToMain.push({AudioToMainMsg::UPDATE_LFOSTEP, 0, (float)lfos[0].getCurrentStep(),
-                      (float)lfos[1].getCurrentStep()});
-    audioToMain.push(
-        {AudioToMainMsg::UPDATE_LFOSTEP, 1, (float)lfos[0].phase, (float)lfos[1].phase});
-    audioToMain.push(
-        {AudioToMainMsg::UPDATE_LFOSTEP, 2, (float)lfos[0].output, (float)lfos[1].output});
+    float vals[3][2]{{(float)lfos[0].getCurrentStep(), (float)lfos[1].getCurrentStep()},
+                     {(float)lfos[0].phase, (float)lfos[1].phase},
+                     {(float)lfos[0].output, (float)lfos[1].output}};
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        if (vals[i][0] == lastSentLfo[i][0] && vals[i][1] == lastSentLfo[i][1])
+            continue;
+        lastSentLfo[i][0] = vals[i][0];
+        lastSentLfo[i][1] = vals[i][1];
+        pushToMain({AudioToMainMsg::UPDATE_LFOSTEP, i, vals[i][0], vals[i][1]});
+    }
 }
 
+#if TWOFILTERS_DSP_TIMING
+void Engine::sendDspTiming()
+{
+    uint32_t which{0};
+    for (auto *h : {&dspTiming.control, &dspTiming.audio})
+    {
+        if (h->count > 0)
+        {
+            pushToMain({AudioToMainMsg::UPDATE_DSP_TIMING, which * 2,
+                        (float)h->percentile(0.5), (float)h->percentile(0.99)});
+            pushToMain({AudioToMainMsg::UPDATE_DSP_TIMING, which * 2 + 1, (float)h->worst,
+                        (float)h->count});
+        }
+        h->reset();
+        which++;
+    }
+}
+#endif
+
 bool Engine::handleAudioToMainMessage(Patch &dest, const AudioToMainMsg &m)
 {
     // Applies the patch-model message (a host-automation param value) to `dest`. Returns
@@ -540,8 +1462,76 @@ void Engine::drainAudioToMainInto(Patch &dest)
     }
 }
 
+namespace
+{
+/*
+ * Each Param holds its own copy of the metadata the prototype built (patch-support's
+ * ParamBase keeps `meta` by value), so every Patch still pays for it. Count it on its own
+ * line rather than hide it in the patch.
+ */
+size_t metadataBytes(const Patch &p)
+{
+    size_t res{0};
+    for (const auto *par : p.params)
+    {
+        res += sizeof(md_t);
+        // strings past the small-string buffer live on the heap
+        for (const auto *str : {&par->meta.name, &par->meta.groupName})
+            if (str->capacity() > 15)
+                res += str->capacity() + 1;
+    }
+    return res;
+}
+
+size_t patchBytes(const Patch &p)
+{
+    auto res = sizeof(Patch) + p.params.capacity() * sizeof(Param *);
+    // a map node is at least the pair and a link
+    res += p.paramMap.size() * (sizeof(std::pair<const uint32_t, Param *>) + sizeof(void *));
+    // the metadata inside the Params is reported by metadataBytes
+    return res - p.params.size() * sizeof(md_t);
+}
+} // namespace
+
+size_t Engine::MemoryReport::total() const
+{
+    size_t res{0};
+    for (const auto &[n, b] : entries)
+        res += b;
+    return res;
+}
+
+Engine::MemoryReport Engine::memoryReport() const
+{
+    MemoryReport r;
+    auto add = [&r](const std::string &n, size_t b) { r.entries.emplace_back(n, b); };
+
+    add("Patch (audio)", patchBytes(patch));
+    add("Patch (main)", patchBytes(patchMain));
+    add("Param metadata (audio)", metadataBytes(patch));
+    add("Param metadata (main)", metadataBytes(patchMain));
+    constexpr auto units = 2 * numFilters;
+    add("Filters", units * sizeof(sst::filtersplusplus::Filter));
+    add("Comb delay lines", units * sizeof(FilterUnit::delays));
+    add("Step LFOs", sizeof(lfos) + sizeof(lfoStorage));
+    add("Oversampling", sizeof(hrUp) + sizeof(hrDn) + sizeof(lpUp) + sizeof(lpDn));
+    add("Queue audio to main", sizeof(audioToMain));
+    add("Queue main to audio", sizeof(mainToAudio));
+    if (parallelRender)
+        add("Parallel render", sizeof(ParallelRender));
+    if (poly)
+        add("Poly voices", sizeof(PolyVoices));
+
+    auto counted = 2 * sizeof(Patch) + sizeof(lfos) + sizeof(lfoStorage) + sizeof(hrUp) +
+                   sizeof(hrDn) + sizeof(lpUp) + sizeof(lpDn) + sizeof(audioToMain) +
+                   sizeof(mainToAudio);
+    add("Other engine state", sizeof(Engine) > counted ? sizeof(Engine) - counted : 0);
+    return r;
+}
+
 void Engine::paramsFlushMainThread(const clap_input_events_t *in, const clap_output_events_t *out)
 {
+    TF_TRACE_SCOPE("main", "Engine::paramsFlushMainThread");
     // host -> plugin: apply incoming param changes in place to patchMain
     bool appliedIncoming{false};
     auto sz = in->size(in);
@@ -633,8 +1623,15 @@ void Engine::paramsFlushMainThread(const clap_input_events_t *in, const clap_out
             fn.config.mt = (sfpp::FilterSubModel)uiM->uintValues[4];
         }
         break;
+        case MainToAudioMsg::SET_PARAM_FOR_TRANSITION:
+        {
+            auto it = patchMain.paramMap.find(uiM->paramId);
+            if (it != patchMain.paramMap.end())
+                it->second->value = uiM->value;
+        }
+        break;
         default:
-            // STOP_AUDIO/START_AUDIO/SEND_POST_LOAD/REQUEST_NON_PATCH_STATE:
+            // STOP_AUDIO/START_AUDIO/SEND_POST_LOAD/REQUEST_NON_PATCH_STATE/*_TRANSITION_LOAD:
             // audio/refresh concerns. When inactive these are handled at activate() (which
             // copies patchMain into patch and rebuilds filters/LFOs) or are irrelevant.
             break;
@@ -644,7 +1641,8 @@ void Engine::paramsFlushMainThread(const clap_input_events_t *in, const clap_out
 }
 
 void Engine::sendEntirePatchToAudio(Patch &patch, mainToAudioQueue_T &mainToAudio,
-                                    const clap_host_t *h, const clap_host_params_t *hostPar)
+                                    const clap_host_t *h, const clap_host_params_t *hostPar,
+                                    int32_t transitionMs)
 {
     if (!h)
         return;
@@ -654,13 +1652,26 @@ void Engine::sendEntirePatchToAudio(Patch &patch, mainToAudioQueue_T &mainToAudi
         hostPar = static_cast<const clap_host_params_t *>(h->get_extension(h, CLAP_EXT_PARAMS));
     }
 
-    mainToAudio.push({MainToAudioMsg::STOP_AUDIO});
-    for (const auto &p : patch.params)
+    if (transitionMs > 0)
+    {
+        MainToAudioMsg bt{MainToAudioMsg::BEGIN_TRANSITION_LOAD};
+        bt.uintValues[0] = (uint32_t)transitionMs;
+        mainToAudio.push(bt);
+        for (const auto &p : patch.params)
+        {
+            mainToAudio.push({MainToAudioMsg::SET_PARAM_FOR_TRANSITION, p->meta.id, p->value});
+        }
+    }
+    else
     {
-        mainToAudio.push({MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, p->meta.id, p->value});
+        mainToAudio.push({MainToAudioMsg::STOP_AUDIO});
+        for (const auto &p : patch.params)
+        {
+            mainToAudio.push({MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, p->meta.id, p->value});
+        }
+        mainToAudio.push({MainToAudioMsg::START_AUDIO});
+        mainToAudio.push({MainToAudioMsg::SEND_POST_LOAD, true});
     }
-    mainToAudio.push({MainToAudioMsg::START_AUDIO});
-    mainToAudio.push({MainToAudioMsg::SEND_POST_LOAD, true});
 
     for (int instance = 0; instance < numFilters; ++instance)
     {
@@ -677,6 +1688,9 @@ void Engine::sendEntirePatchToAudio(Patch &patch, mainToAudioQueue_T &mainToAudi
         mainToAudio.push(msg);
     }
 
+    if (transitionMs > 0)
+        mainToAudio.push({MainToAudioMsg::END_TRANSITION_LOAD});
+
     // A load is a bulk out-of-band value change. We are on the main thread and the host reads
     // values/text from patchMain, which the caller already updated, so tell the host to
     // re-read directly rather than round-tripping a rescan request through the audio thread.
@@ -17,9 +17,15 @@
 #define BACONPAUL_TWOFILTERS_ENGINE_ENGINE_H
 
 #include <memory>
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cstring>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "sst/basic-blocks/dsp/LanczosResampler.h"
 
@@ -37,9 +43,16 @@
 #include "configuration.h"
 
 #include "engine/patch.h"
+#include "engine/dsp-timing.h"
+#include "engine/block-noise.h"
+#include "engine/cpu-governor.h"
+#include "engine/filter-unit.h"
+#include "engine/linear-phase-halfband.h"
+#include "engine/parallel-render.h"
+#include "engine/poly-voices.h"
+#include "engine/trace-recorder.h"
 
 #include "sst/basic-blocks/dsp/LagCollection.h"
-#include "sst/basic-blocks/dsp/CorrelatedNoise.h"
 #include "sst/basic-blocks/dsp/BlockInterpolators.h"
 #include "sst/filters++.h"
 #include "sst/filters/HalfRateFilter.h"
@@ -71,7 +84,40 @@ struct Engine
     Engine();
     ~Engine();
 
-    std::array<sst::filtersplusplus::Filter, numFilters> filters;
+    // Each filter has two slots. The live slot is what the routing hears; during a preset
+    // transition or a prepared model change the other slot keeps running the outgoing model
+    // and is crossfaded out, so neither has to reset the filter the listener is hearing.
+    std::array<std::array<std::unique_ptr<FilterUnit>, numFilters>, 2> filterSlots;
+    int liveSlot[numFilters]{0, 0};
+    sst::filtersplusplus::Filter &liveFilter(int f) { return filterSlots[liveSlot[f]][f]->filter; }
+    sst::filtersplusplus::Filter &fadingFilter(int f)
+    {
+        return filterSlots[1 - liveSlot[f]][f]->filter;
+    }
+
+    /*
+     * Model changes prepared off the audio thread; see FilterUnit. The editor calls
+     * prepareStandbyFilter from patchMain just before it sends SET_FILTER_MODEL, which then
+     * crossfades to the prepared unit over modelSwapSeconds instead of resetting the filter.
+     * Each pointer has one owner at a time: the main thread fills standbyFilter with an
+     * exchange, and the audio thread empties it with one.
+     */
+    static constexpr double modelSwapSeconds{0.005};
+    std::atomic<FilterUnit *> standbyFilter[numFilters]{};
+    // Each prepare first collects what was retired, and each standby unit leads to one
+    // retirement at most, so this shouldn't fill. If the main thread falls behind anyway,
+    // units wait on retireBacklog (audio thread only) and are pushed again each control
+    // block, so none is lost.
+    sst::cpputils::SimpleRingBuffer<FilterUnit *, 16> retiredFilters;
+    FilterUnit *retireBacklog{nullptr};
+    void pushRetireBacklog();
+    // What the audio thread configures filters for, published for prepareStandbyFilter
+    std::atomic<double> filterSampleRate{0};
+    std::atomic<uint32_t> filterBlockSize{0};
+    void prepareStandbyFilter(int f);     // main thread
+    uint32_t collectRetiredFilters();     // main thread; returns how many it freed
+    FilterUnit *takeStandbyFilter(int f); // nullptr unless one matches the current setup
+    void retireFilter(FilterUnit *u);
     bool useFeedback{false};
     float fbL{0}, fbR{0}, fb2L{0}, fb2R{0};
 
@@ -80,7 +126,8 @@ struct Engine
     static_assert(maxSteps <= stepLfo_t::Storage::stepLfoSteps);
     std::array<stepLfo_t, numStepLFOs> lfos;
     std::array<stepLfo_t::Storage, numStepLFOs> lfoStorage;
-    sst::basic_blocks::tables::EqualTuningProvider tuningProvider;
+    // One table for the process, built on first use; engines and UI previews only read it.
+    static sst::basic_blocks::tables::EqualTuningProvider &sharedTuningProvider();
     sst::basic_blocks::modulators::Transport transport;
     uint32_t lastStatus{sst::basic_blocks::modulators::Transport::STOPPED};
 
@@ -100,70 +147,295 @@ struct Engine
 
     void processControl(const clap_output_events_t *);
 
-    bool overSampling{false};
+    bool overSampling{false}, linearPhase{false};
+
+    /*
+     * CPU governor levels; see CpuGovernor. The plugin calls governorEndProcess after each
+     * host buffer, which decides when a level may change, and processControl applies it.
+     * It also pads the output whenever less oversampling runs than the latency reported.
+     * Coarse control configures the filters for, and ramps the lipols across, two blocks;
+     * it only runs with oversampling off, so filter-rate buffers keep their 2 * blockSize.
+     */
+    bool cpuGovernorOn{false};
+    CpuGovernor cpuGovernor;
+    uint32_t governedLevel{CpuGovernor::Full}, appliedGovernorLevel{CpuGovernor::Full};
+    bool coarseControl{false}, lowTelemetry{false};
+    bool governorRebuilds(uint32_t from, uint32_t to) const;
+    void governorEndProcess(float *outL, float *outR, uint32_t frames, double seconds);
+    void applyGovernedLevel();
+
+    /*
+     * Offline rendering, which the plugin learns from the CLAP render extension. With the
+     * patch's Offline Quality on, a bounce runs a higher quality profile: oversampling even
+     * where the patch has it off, and a control block every host sample, so the filter
+     * coefficients, routing lipols and param lags all move per sample. Nothing is governed
+     * offline. The start of a render reseeds the noise and the LFOs' random source and resets
+     * every filter, oversampler, loop and glide, so two bounces of a session match. Back in
+     * realtime the patch's own settings return.
+     */
+    std::atomic<bool> offlineRender{false}; // the plugin's render mode, set on the main thread
+    bool renderingOffline{false}, renderBoost{false}; // the audio thread's view of it
+    bool renderStarting{false}; // until the first render block's processControl is done
+    static constexpr uint32_t renderControlBlockSize{1};
+    static constexpr uint64_t renderSeed{0x7F4A7C159E3779B9ULL};
+    static bool renderBoostFor(const Patch &p, bool offline)
+    {
+        return offline && p.routingNode.offlineQuality > 0.5;
+    }
+    // The plugin starts a control block when this is true, so a render always starts on one
+    bool renderModeChanging() const
+    {
+        return offlineRender.load(std::memory_order_relaxed) != renderingOffline;
+    }
+    void startOfflineRender();
+    // Render mode, governor, control block size and oversampling, from processControl. The
+    // plugin also runs it before a process call whose render mode changed, so that call
+    // already picks the templates the new setup needs.
+    void updateRenderSetup();
+
+    // Host samples from one processControl to the next: blockSize, twice that with coarse
+    // control, or renderControlBlockSize. Changing it rebuilds the filters for the new block.
+    uint32_t controlBlockSize{blockSize};
+    void setControlBlockSize(uint32_t n);
+    uint32_t filterBlockSamples() const { return controlBlockSize * (overSampling ? 2 : 1); }
     sst::filters::HalfRate::HalfRateFilter hrUp, hrDn;
+    LinearPhaseHalfBand lpUp, lpDn; // instead of hrUp / hrDn when linearPhase
 
-    float noiseState[2][2]{0, 0};
+    void upsample(float inL, float inR, float *outL, float *outR)
+    {
+        if (linearPhase)
+            lpUp.process_sample_U2(inL, inR, outL, outR);
+        else
+            hrUp.process_sample_U2(inL, inR, outL, outR);
+    }
+    void downsample(float *inL, float *inR, float &outL, float &outR)
+    {
+        if (linearPhase)
+            lpDn.process_sample_D2(inL, inR, outL, outR);
+        else
+            hrDn.process_sample_D2(inL, inR, outL, outR);
+    }
+
+    // Oversampling delays everything, the dry side of mix included since it is taken after
+    // the upsampler, so this is the whole plugin's latency. The IIR pair has no single
+    // delay; it reports its (rounded) group delay at low frequencies. A patch with Offline
+    // Quality on always reports the oversampled latency, since a bounce can't restart to
+    // change it; in realtime the output is padded up to it.
+    static uint32_t latencyFor(const Patch &p);
+    uint32_t runningLatency() const; // what the current oversampling setup actually delays
+    static uint32_t iirOversamplingLatency();
+    uint32_t reportedLatency{0}; // what the host was last told; set by the plugin on activate
+    bool latencyRestartRequested{false};
+
+    // Refilled by processControl for the coming block while noise is on
+    BlockNoise noise;
+    uint32_t noisePos{0};
     using lipol_t = sst::basic_blocks::dsp::lipol<float, blockSize, true>;
     lipol_t blendLipol1, blendLipol2;
     lipol_t inGainLipol, outGainLipol, noiseGainLipol, fbLevelLipol, mixLipol;
 
+    // Preset transition state. transitionBlocks == 0 is the classic stop / reset / start
+    // load; otherwise a load crossfades filters whose model changed over that many blocks,
+    // converted from the milliseconds the load asked for.
+    int32_t transitionBlocks{0};
+    bool transitionLoadActive{false};
+    bool fadeActive[numFilters]{false, false};
+    int32_t fadeBlocks[numFilters]{1, 1}, fadeBlocksLeft[numFilters]{0, 0};
+    sst::filtersplusplus::FilterModel fadeModel[numFilters]{};
+    sst::filtersplusplus::ModelConfig fadeConfig[numFilters]{};
+    lipol_t fadeLipol[numFilters];
+    // Into `prepared`, or a unit set up here when there is none
+    void crossfadeToFilterModel(int f, int32_t blocks, FilterUnit *prepared = nullptr);
+
+    // Each block's filter settings from processControl. Applied straight away, unless a
+    // parallel render is deferring them to the task running that filter.
+    FilterControl filterControl[numFilters];
+    bool deferFilterControl{false};
+    void applyFilterControl(int f, const FilterControl &c);
+    // From the patch and step LFOs, plus a modulation offset per PolyModTarget and keytracking
+    FilterControl filterControlFor(int f, const float *lfoOut, const float *mod,
+                                   float keyOffset) const;
+    float panFor(int f, const float *lfoOut, const float *mod) const;
+
+    // CLAP param modulation of the filters with no note, which both modes add
+    float paramMod[numFilters][numPolyModTargets]{};
+
+    inline void processFilterSample(int f, float inL, float inR, float &outL, float &outR)
+    {
+        liveFilter(f).processStereoSample(inL, inR, outL, outR);
+        if (fadeActive[f])
+        {
+            float oL, oR;
+            fadingFilter(f).processStereoSample(inL, inR, oL, oR);
+            auto g = fadeLipol[f].v;
+            outL = g * outL + (1 - g) * oL;
+            outR = g * outR + (1 - g) * oR;
+        }
+    }
+
     sst::basic_blocks::dsp::pan_laws::panmatrix_t panMatrix[2];
     sst::basic_blocks::dsp::OnePoleLag<float, true> panLag[2];
 
-    void applyPan(float &L, float &R, int which)
+    static void applyPanMatrix(float &L, float &R,
+                               const sst::basic_blocks::dsp::pan_laws::panmatrix_t &m)
     {
-        auto tL = (panMatrix[which][0] * L + panMatrix[which][2] * R);
-        auto tR = (panMatrix[which][1] * R + panMatrix[which][3] * L);
+        auto tL = (m[0] * L + m[2] * R);
+        auto tR = (m[1] * R + m[3] * L);
         L = tL;
         R = tR;
     }
+    void applyPan(float &L, float &R, int which) { applyPanMatrix(L, R, panMatrix[which]); }
+
+    // The lipols ramp over blockSize steps and reach their target in one control block, so
+    // each filter-rate sample takes blockSize / filterBlockSamples() of a step: one normally,
+    // halves when oversampling or with coarse control, several in an offline render.
+    float lipolStep[2]{1.f, 0.5f}; // [withOversampling]
+    template <bool withOversampling> void advanceLipol(lipol_t &l) const
+    {
+        auto st = lipolStep[withOversampling];
+        if (st == 1.f)
+            l.process();
+        else
+            l.processPartial(st);
+    }
+    template <bool withOversampling> void advanceRoutingLipols()
+    {
+        for (auto *l : {&blendLipol1, &blendLipol2, &inGainLipol, &outGainLipol, &noiseGainLipol,
+                        &fbLevelLipol, &mixLipol})
+            advanceLipol<withOversampling>(*l);
+    }
+    template <bool withOversampling> void advanceFadeLipol(int f)
+    {
+        advanceLipol<withOversampling>(fadeLipol[f]);
+    }
 
     template <RoutingModes mode, bool fb, bool withNoise, bool withOversampling>
     void processAudio(float inL, float inR, float &outL, float &outR)
     {
+        if constexpr (!withNoise)
+        {
+            if (monoBlock)
+            {
+                processAudioMono<mode, fb, withOversampling>(inL, outL);
+                outR = outL;
+                if (meterThisBlock)
+                    vuPeak.process(outL, outR);
+                return;
+            }
+        }
+
         if (withOversampling)
         {
             float inLU[2], inRU[2], outLU[2], outRU[2];
-            hrUp.process_sample_U2(inL, inR, inLU, inRU);
+            upsample(inL, inR, inLU, inRU);
             processAudioNoOS<mode, fb, withNoise>(inLU[0], inRU[0], outLU[0], outRU[0]);
-            blendLipol1.processPartial(0.5);
-            blendLipol2.processPartial(0.5);
-            inGainLipol.processPartial(0.5);
-            outGainLipol.processPartial(0.5);
-            noiseGainLipol.processPartial(0.5);
-            fbLevelLipol.processPartial(0.5);
-            mixLipol.processPartial(0.5);
+            advanceRoutingLipols<true>();
+            for (int f = 0; f < (int)numFilters; ++f)
+                advanceFadeLipol<true>(f);
 
             processAudioNoOS<mode, fb, withNoise>(inLU[1], inRU[1], outLU[1], outRU[1]);
-            blendLipol1.processPartial(0.5);
-            blendLipol2.processPartial(0.5);
-            inGainLipol.processPartial(0.5);
-            outGainLipol.processPartial(0.5);
-            noiseGainLipol.processPartial(0.5);
-            fbLevelLipol.processPartial(0.5);
-            mixLipol.processPartial(0.5);
+            advanceRoutingLipols<true>();
+            for (int f = 0; f < (int)numFilters; ++f)
+                advanceFadeLipol<true>(f);
 
-            hrDn.process_sample_D2(outLU, outRU, outL, outR);
+            downsample(outLU, outRU, outL, outR);
         }
         else
         {
             processAudioNoOS<mode, fb, withNoise>(inL, inR, outL, outR);
-            blendLipol1.process();
-            blendLipol2.process();
-            inGainLipol.process();
-            outGainLipol.process();
-            noiseGainLipol.process();
-            fbLevelLipol.process();
-            mixLipol.process();
+            advanceRoutingLipols<false>();
+            for (int f = 0; f < (int)numFilters; ++f)
+                advanceFadeLipol<false>(f);
         }
 
-        if (editorActive.load(std::memory_order_relaxed))
+        stereoBlockSymmetric = stereoBlockSymmetric && outL == outR;
+
+        if (meterThisBlock)
         {
             vuPeak.process(outL, outR);
         }
     }
 
+    /*
+     * Mono input. Hosts often feed a mono source as identical L / R; when nothing in the
+     * patch can pull the sides apart (no noise, pans and feedback symmetric) a block runs
+     * processAudioMono, which computes the left side and copies it. The filters still run
+     * their stereo pair, which filters++ processes in one SIMD lane set either way, and so
+     * stay exactly symmetric; the saving is the per side routing and, with linear phase
+     * oversampling, half the FIR work. Mono is only entered after a stereo block came out
+     * with L == R throughout, in each filter's output as well as the mix, so no stereo tail
+     * is left even in a filter the blend or pan hides. Leaving it needs no fade since both
+     * sides are the same at that point.
+     */
+    bool monoBlock{false};
+    bool stereoBlockSymmetric{false};
+
+    // A filter's sides as it produced them, before its pan
+    template <bool mono = false> void trackFilterSymmetry(float L, float R)
+    {
+        if constexpr (!mono)
+            stereoBlockSymmetric = stereoBlockSymmetric && L == R;
+    }
+
+    // At each block start, with the block's input or nullptr if it isn't all here yet
+    void chooseMonoBlock(const float *inL, const float *inR)
+    {
+        auto symmetric = monoBlock || stereoBlockSymmetric;
+        stereoBlockSymmetric = true;
+
+        auto panSym = [this](int f)
+        { return panMatrix[f][0] == panMatrix[f][1] && panMatrix[f][2] == panMatrix[f][3]; };
+        auto m = inL && inR && symmetric && !ecoFeedback && !polyMode && fbL == fbR &&
+                 fb2L == fb2R && panSym(0) && panSym(1) &&
+                 memcmp(inL, inR, controlBlockSize * sizeof(float)) == 0;
+
+        if (monoBlock && !m)
+        {
+            lpUp.copyLeftToRight();
+            lpDn.copyLeftToRight();
+        }
+        monoBlock = m;
+    }
+
+    template <RoutingModes mode, bool fb, bool withOversampling>
+    void processAudioMono(float in, float &out)
+    {
+        float dup;
+        if constexpr (withOversampling)
+        {
+            float inU[2], outU[2];
+            if (linearPhase)
+            {
+                lpUp.process_sample_U2(in, inU);
+            }
+            else
+            {
+                float inUR[2];
+                hrUp.process_sample_U2(in, in, inU, inUR);
+            }
+
+            for (int h = 0; h < 2; ++h)
+            {
+                processAudioNoOS<mode, fb, false, true>(inU[h], inU[h], outU[h], dup);
+                advanceRoutingLipols<true>();
+                for (int f = 0; f < (int)numFilters; ++f)
+                    advanceFadeLipol<true>(f);
+            }
+
+            if (linearPhase)
+                lpDn.process_sample_D2(outU, out);
+            else
+                hrDn.process_sample_D2(outU, outU, out, dup);
+        }
+        else
+        {
+            processAudioNoOS<mode, fb, false, true>(in, in, out, dup);
+            advanceRoutingLipols<false>();
+            for (int f = 0; f < (int)numFilters; ++f)
+                advanceFadeLipol<false>(f);
+        }
+    }
+
     // y = x * ( 27 + x * x ) / ( 27 + 9 * x * x );
     inline float sat(float x) const
     {
@@ -171,9 +443,16 @@ struct Engine
         return x * (27 + x * x) / (27 + 9 * x * x);
     };
 
-    template <RoutingModes mode, bool fb, bool withNoise>
+    // With mono the right side is taken to equal the left, so its sums fold away.
+    template <RoutingModes mode, bool fb, bool withNoise, bool mono = false>
     void processAudioNoOS(float inL, float inR, float &outL, float &outR)
     {
+        auto mirror = [](float &L, float &R)
+        {
+            if constexpr (mono)
+                R = L;
+        };
+
         if (!audioRunning)
         {
             outL = 0;
@@ -184,6 +463,14 @@ struct Engine
         auto origL = inL;
         auto origR = inR;
 
+        // The loop state this sample reads and then overwrites: the previous sample's, or
+        // with eco feedback the same sample in the previous block
+        auto ep = ecoPos++ & (ecoCapacity - 1);
+        auto &loopL = ecoFeedback ? ecoFb[0][0][ep] : fbL;
+        auto &loopR = ecoFeedback ? ecoFb[0][1][ep] : fbR;
+        auto &loop2L = ecoFeedback ? ecoFb[1][0][ep] : fb2L;
+        auto &loop2R = ecoFeedback ? ecoFb[1][1][ep] : fb2R;
+
         float inG = inGainLipol.v;
         inL *= inG;
         inR *= inG;
@@ -191,28 +478,29 @@ struct Engine
         if constexpr (withNoise)
         {
             float nsG = noiseGainLipol.v;
-            auto n1 = sst::basic_blocks::dsp::correlated_noise_o2mk2_supplied_value(
-                noiseState[0][0], noiseState[0][1], 0, rng.unifPM1());
-            auto n2 = sst::basic_blocks::dsp::correlated_noise_o2mk2_supplied_value(
-                noiseState[1][0], noiseState[1][1], 0, rng.unifPM1());
-            inL += nsG * n1;
-            inR += nsG * n2;
+            auto ni = noisePos++ & (BlockNoise::maxSamples - 1);
+            inL += nsG * noise.values[0][ni];
+            inR += nsG * noise.values[1][ni];
         }
 
         if constexpr (mode == RoutingModes::Serial)
         {
             if constexpr (fb)
             {
-                inL += fbL;
-                inR += fbR;
+                inL += loopL;
+                inR += loopR;
             }
 
             float out1L, out1R, out2L, out2R;
-            filters[0].processStereoSample(inL, inR, out1L, out1R);
+            processFilterSample(0, inL, inR, out1L, out1R);
+            trackFilterSymmetry<mono>(out1L, out1R);
             applyPan(out1L, out1R, 0);
+            mirror(out1L, out1R);
 
-            filters[1].processStereoSample(out1L, out1R, out2L, out2R);
+            processFilterSample(1, out1L, out1R, out2L, out2R);
+            trackFilterSymmetry<mono>(out2L, out2R);
             applyPan(out2L, out2R, 1);
+            mirror(out2L, out2R);
 
             outL = blendLipol1.v * out1L + blendLipol2.v * out2L;
             outR = blendLipol1.v * out1R + blendLipol2.v * out2R;
@@ -221,24 +509,28 @@ struct Engine
             {
                 auto fblev = fbLevelLipol.v;
 
-                fbL = sat(fblev * outL);
-                fbR = sat(fblev * outR);
+                loopL = sat(fblev * outL);
+                loopR = sat(fblev * outR);
             }
         }
         else if constexpr (mode == RoutingModes::Parallel_FBBoth)
         {
             if constexpr (fb)
             {
-                inL += fbL;
-                inR += fbR;
+                inL += loopL;
+                inR += loopR;
             }
 
             float t0L, t0R, t1L, t1R;
-            filters[0].processStereoSample(inL, inR, t0L, t0R);
-            filters[1].processStereoSample(inL, inR, t1L, t1R);
+            processFilterSample(0, inL, inR, t0L, t0R);
+            processFilterSample(1, inL, inR, t1L, t1R);
+            trackFilterSymmetry<mono>(t0L, t0R);
+            trackFilterSymmetry<mono>(t1L, t1R);
 
             applyPan(t0L, t0R, 0);
             applyPan(t1L, t1R, 1);
+            mirror(t0L, t0R);
+            mirror(t1L, t1R);
             outL = blendLipol1.v * t0L + blendLipol2.v * t1L;
             outR = blendLipol1.v * t0R + blendLipol2.v * t1R;
 
@@ -246,24 +538,28 @@ struct Engine
             if constexpr (fb)
             {
                 float fblev = fbLevelLipol.v;
-                fbL = sat(fblev * outL);
-                fbR = sat(fblev * outR);
+                loopL = sat(fblev * outL);
+                loopR = sat(fblev * outR);
             }
         }
         else if constexpr (mode == RoutingModes::Parallel_FBOne)
         {
             float t0L, t0R, t1L, t1R;
-            filters[1].processStereoSample(inL, inR, t1L, t1R);
+            processFilterSample(1, inL, inR, t1L, t1R);
 
             if constexpr (fb)
             {
-                inL += fbL;
-                inR += fbR;
+                inL += loopL;
+                inR += loopR;
             }
-            filters[0].processStereoSample(inL, inR, t0L, t0R);
+            processFilterSample(0, inL, inR, t0L, t0R);
+            trackFilterSymmetry<mono>(t0L, t0R);
+            trackFilterSymmetry<mono>(t1L, t1R);
 
             applyPan(t0L, t0R, 0);
             applyPan(t1L, t1R, 1);
+            mirror(t0L, t0R);
+            mirror(t1L, t1R);
             outL = blendLipol1.v * t0L + blendLipol2.v * t1L;
             outR = blendLipol1.v * t0R + blendLipol2.v * t1R;
 
@@ -272,8 +568,8 @@ struct Engine
                 // Only need to run 1 if we have feedback
                 float fblev = fbLevelLipol.v;
 
-                fbL = sat(fblev * t0L);
-                fbR = sat(fblev * t0R);
+                loopL = sat(fblev * t0L);
+                loopR = sat(fblev * t0R);
             }
         }
         else if constexpr (mode == RoutingModes::Parallel_FBEach)
@@ -283,20 +579,24 @@ struct Engine
 
             if constexpr (fb)
             {
-                i1L += fbL;
-                i1R += fbR;
+                i1L += loopL;
+                i1R += loopR;
             }
-            filters[0].processStereoSample(i1L, i1R, t0L, t0R);
+            processFilterSample(0, i1L, i1R, t0L, t0R);
 
             if constexpr (fb)
             {
-                i2L += fb2L;
-                i2R += fb2R;
+                i2L += loop2L;
+                i2R += loop2R;
             }
-            filters[1].processStereoSample(i2L, i2R, t1L, t1R);
+            processFilterSample(1, i2L, i2R, t1L, t1R);
+            trackFilterSymmetry<mono>(t0L, t0R);
+            trackFilterSymmetry<mono>(t1L, t1R);
 
             applyPan(t0L, t0R, 0);
             applyPan(t1L, t1R, 1);
+            mirror(t0L, t0R);
+            mirror(t1L, t1R);
             outL = blendLipol1.v * t0L + blendLipol2.v * t1L;
             outR = blendLipol1.v * t0R + blendLipol2.v * t1R;
 
@@ -305,10 +605,191 @@ struct Engine
                 // Only need to run 1 if we have feedback
                 float fblev = fbLevelLipol.v;
 
-                fbL = sat(fblev * t0L);
-                fbR = sat(fblev * t0R);
-                fb2L = sat(fblev * t1L);
-                fb2R = sat(fblev * t1R);
+                loopL = sat(fblev * t0L);
+                loopR = sat(fblev * t0R);
+                loop2L = sat(fblev * t1L);
+                loop2R = sat(fblev * t1R);
+            }
+        }
+
+        auto mx = mixLipol.v;
+        auto outG = outGainLipol.v;
+
+        outL *= outG;
+        outR *= outG;
+
+        outL = mx * outL + (1.0 - mx) * origL;
+        outR = mx * outR + (1.0 - mx) * origR;
+
+        outL = std::clamp(outL, -2.5f, 2.5f);
+        outR = std::clamp(outR, -2.5f, 2.5f);
+    }
+
+    // Poly mode; see PolyVoices. Notes are ignored without it, and it is only on once
+    // setupPolyVoices has run.
+    std::unique_ptr<PolyVoices> poly;
+    bool polyMode{false};
+    float keytrack{1};
+    void setupPolyVoices(); // main thread, while deactivated
+    void setupPolyFilter(int f);
+    // Set up again before poly mode next uses them; a hot swap doesn't stop for the voices
+    bool polyFilterStale[numFilters]{false, false};
+    void polyNoteOn(int16_t port, int16_t channel, int16_t key, int32_t noteId);
+    void polyNoteOff(int16_t port, int16_t channel, int16_t key, int32_t noteId);
+    void polyNoteChoke(int16_t port, int16_t channel, int16_t key, int32_t noteId);
+    // From the voice manager's responder: a free slot set up for the note, or -1
+    int startPolyVoice(int16_t port, int16_t channel, int16_t key, int32_t noteId);
+    // Frees the slot, queues its NOTE_END and tells the voice manager
+    void endPolyVoice(int v);
+    bool polyModTargetFor(uint32_t pid, int &f, int &t) const;
+    void paramModulation(uint32_t pid, int16_t port, int16_t channel, int16_t key,
+                         int32_t noteId, float amount);
+    void processPolyControl(const clap_output_events_t *);
+
+    template <RoutingModes mode, bool fb, bool withNoise, bool withOversampling>
+    void processPoly(float inL, float inR, float &outL, float &outR)
+    {
+        auto advance = [this]()
+        {
+            advanceRoutingLipols<withOversampling>();
+            for (auto &v : poly->voices)
+                advanceLipol<withOversampling>(v.gate);
+        };
+
+        if constexpr (withOversampling)
+        {
+            float inLU[2], inRU[2], outLU[2], outRU[2];
+            upsample(inL, inR, inLU, inRU);
+            for (int h = 0; h < 2; ++h)
+            {
+                processPolyNoOS<mode, fb, withNoise>(inLU[h], inRU[h], outLU[h], outRU[h]);
+                advance();
+            }
+            downsample(outLU, outRU, outL, outR);
+        }
+        else
+        {
+            processPolyNoOS<mode, fb, withNoise>(inL, inR, outL, outR);
+            advance();
+        }
+
+        // The stereo filters sit this out, so their state says nothing about a mono block
+        stereoBlockSymmetric = false;
+
+        if (meterThisBlock)
+        {
+            vuPeak.process(outL, outR);
+        }
+    }
+
+    template <RoutingModes mode, bool fb, bool withNoise>
+    void processPolyNoOS(float inL, float inR, float &outL, float &outR)
+    {
+        if (!audioRunning)
+        {
+            outL = 0;
+            outR = 0;
+            return;
+        }
+
+        auto origL = inL;
+        auto origR = inR;
+
+        float inG = inGainLipol.v;
+        inL *= inG;
+        inR *= inG;
+
+        if constexpr (withNoise)
+        {
+            float nsG = noiseGainLipol.v;
+            auto ni = noisePos++ & (BlockNoise::maxSamples - 1);
+            inL += nsG * noise.values[0][ni];
+            inR += nsG * noise.values[1][ni];
+        }
+
+        auto mid = 0.5f * (inL + inR);
+        auto b1 = blendLipol1.v;
+        auto b2 = blendLipol2.v;
+        auto fblev = fbLevelLipol.v;
+
+        auto &pv = *poly;
+        outL = 0;
+        outR = 0;
+        for (int p = 0; p < PolyVoices::numPacks; ++p)
+        {
+            if (!pv.packActive(p))
+                continue;
+
+            // Each lane of a pack's filters is one voice
+            auto *vs = &pv.voices[p * PolyVoices::lanes];
+            auto &flt = pv.filters[p];
+
+            float in[PolyVoices::lanes], x0[PolyVoices::lanes], t0[PolyVoices::lanes],
+                t1[PolyVoices::lanes];
+            for (int l = 0; l < PolyVoices::lanes; ++l)
+            {
+                in[l] = vs[l].active ? mid : 0.f;
+                x0[l] = in[l];
+                if constexpr (fb)
+                    x0[l] += vs[l].fb;
+            }
+            flt[0].processQuadSample(x0, t0);
+
+            if constexpr (mode == RoutingModes::Serial)
+            {
+                flt[1].processQuadSample(t0, t1);
+            }
+            else if constexpr (mode == RoutingModes::Parallel_FBBoth)
+            {
+                flt[1].processQuadSample(x0, t1);
+            }
+            else if constexpr (mode == RoutingModes::Parallel_FBOne)
+            {
+                flt[1].processQuadSample(in, t1);
+            }
+            else
+            {
+                float x1[PolyVoices::lanes];
+                for (int l = 0; l < PolyVoices::lanes; ++l)
+                {
+                    x1[l] = in[l];
+                    if constexpr (fb)
+                        x1[l] += vs[l].fb2;
+                }
+                flt[1].processQuadSample(x1, t1);
+            }
+
+            for (int l = 0; l < PolyVoices::lanes; ++l)
+            {
+                auto &v = vs[l];
+                if (!v.active)
+                {
+                    // An ended voice's loop stops with it, so its lane only rings down
+                    v.fb = 0;
+                    v.fb2 = 0;
+                    continue;
+                }
+                if constexpr (fb)
+                {
+                    if constexpr (mode == RoutingModes::Serial ||
+                                  mode == RoutingModes::Parallel_FBBoth)
+                    {
+                        v.fb = sat(fblev * (b1 * t0[l] + b2 * t1[l]));
+                    }
+                    else
+                    {
+                        v.fb = sat(fblev * t0[l]);
+                        if constexpr (mode == RoutingModes::Parallel_FBEach)
+                            v.fb2 = sat(fblev * t1[l]);
+                    }
+                }
+
+                float p0L{t0[l]}, p0R{t0[l]}, p1L{t1[l]}, p1R{t1[l]};
+                applyPanMatrix(p0L, p0R, v.pan[0]);
+                applyPanMatrix(p1L, p1R, v.pan[1]);
+                auto g = v.gate.v;
+                outL += g * (b1 * p0L + b2 * p1L);
+                outR += g * (b1 * p0R + b2 * p1R);
             }
         }
 
@@ -325,6 +806,369 @@ struct Engine
         outR = std::clamp(outR, -2.5f, 2.5f);
     }
 
+    /*
+     * Eco feedback. Each loop hears the feedback from the same point in the previous control
+     * block rather than from the previous sample, so within a block neither filter waits on
+     * the blend, and processBlockEco runs each filter through the whole block in its own
+     * loop. A gentle loop sounds the same; a hot one resonates at the block rate, which is
+     * why it is a choice. processAudioNoOS reads and writes the same buffers, so a block the
+     * plugin can't hand over whole (split across process calls, or stopped) matches.
+     */
+    static constexpr uint32_t ecoCapacity{blockSize * 2}; // oversampled
+    bool ecoFeedback{false};
+    float ecoFb[numFilters][2][ecoCapacity]{}; // [loop][channel][filter-rate sample]
+    uint32_t ecoPos{0};
+    void setEcoFeedback(bool on);
+
+    // One whole block, straight after its processControl
+    template <RoutingModes mode, bool withNoise, bool withOversampling>
+    void processBlockEco(const float *inL, const float *inR, float *outL, float *outR)
+    {
+        if (!audioRunning)
+        {
+            for (uint32_t h = 0; h < blockSize; ++h)
+                processAudio<mode, true, withNoise, withOversampling>(inL[h], inR[h], outL[h],
+                                                                      outR[h]);
+            return;
+        }
+
+        constexpr uint32_t n{blockSize * (withOversampling ? 2 : 1)};
+        float dryL[n], dryR[n], iL[n], iR[n], t0L[n], t0R[n], t1L[n], t1R[n];
+        float blend1[n], blend2[n], fbLevel[n], mix[n], outGain[n];
+
+        for (uint32_t h = 0; h < blockSize; ++h)
+        {
+            if constexpr (withOversampling)
+            {
+                upsample(inL[h], inR[h], dryL + 2 * h, dryR + 2 * h);
+            }
+            else
+            {
+                dryL[h] = inL[h];
+                dryR[h] = inR[h];
+            }
+        }
+
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            float inG = inGainLipol.v;
+            iL[i] = dryL[i] * inG;
+            iR[i] = dryR[i] * inG;
+            if constexpr (withNoise)
+            {
+                float nsG = noiseGainLipol.v;
+                iL[i] += nsG * noise.values[0][i];
+                iR[i] += nsG * noise.values[1][i];
+            }
+            blend1[i] = blendLipol1.v;
+            blend2[i] = blendLipol2.v;
+            fbLevel[i] = fbLevelLipol.v;
+            mix[i] = mixLipol.v;
+            outGain[i] = outGainLipol.v;
+            advanceRoutingLipols<withOversampling>();
+        }
+        if constexpr (withNoise)
+            noisePos += n;
+        ecoPos += n;
+
+        // The first filter hears the first loop in every mode
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            processFilterSample(0, iL[i] + ecoFb[0][0][i], iR[i] + ecoFb[0][1][i], t0L[i],
+                                t0R[i]);
+            trackFilterSymmetry(t0L[i], t0R[i]);
+            applyPan(t0L[i], t0R[i], 0);
+            advanceFadeLipol<withOversampling>(0);
+        }
+
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            float aL{iL[i]}, aR{iR[i]};
+            if constexpr (mode == RoutingModes::Serial)
+            {
+                aL = t0L[i];
+                aR = t0R[i];
+            }
+            else if constexpr (mode == RoutingModes::Parallel_FBBoth)
+            {
+                aL += ecoFb[0][0][i];
+                aR += ecoFb[0][1][i];
+            }
+            else if constexpr (mode == RoutingModes::Parallel_FBEach)
+            {
+                aL += ecoFb[1][0][i];
+                aR += ecoFb[1][1][i];
+            }
+            processFilterSample(1, aL, aR, t1L[i], t1R[i]);
+            trackFilterSymmetry(t1L[i], t1R[i]);
+            applyPan(t1L[i], t1R[i], 1);
+            advanceFadeLipol<withOversampling>(1);
+        }
+
+        // Blend, and leave this block's loops for the next one, in place of the inputs
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            float oL = blend1[i] * t0L[i] + blend2[i] * t1L[i];
+            float oR = blend1[i] * t0R[i] + blend2[i] * t1R[i];
+
+            if constexpr (mode == RoutingModes::Serial || mode == RoutingModes::Parallel_FBBoth)
+            {
+                ecoFb[0][0][i] = sat(fbLevel[i] * oL);
+                ecoFb[0][1][i] = sat(fbLevel[i] * oR);
+            }
+            else
+            {
+                ecoFb[0][0][i] = sat(fbLevel[i] * t0L[i]);
+                ecoFb[0][1][i] = sat(fbLevel[i] * t0R[i]);
+                if constexpr (mode == RoutingModes::Parallel_FBEach)
+                {
+                    ecoFb[1][0][i] = sat(fbLevel[i] * t1L[i]);
+                    ecoFb[1][1][i] = sat(fbLevel[i] * t1R[i]);
+                }
+            }
+
+            oL *= outGain[i];
+            oR *= outGain[i];
+
+            oL = mix[i] * oL + (1.0 - mix[i]) * dryL[i];
+            oR = mix[i] * oR + (1.0 - mix[i]) * dryR[i];
+
+            t0L[i] = std::clamp(oL, -2.5f, 2.5f);
+            t0R[i] = std::clamp(oR, -2.5f, 2.5f);
+        }
+
+        auto vu = meterThisBlock;
+        for (uint32_t h = 0; h < blockSize; ++h)
+        {
+            if constexpr (withOversampling)
+            {
+                downsample(t0L + 2 * h, t0R + 2 * h, outL[h], outR[h]);
+            }
+            else
+            {
+                outL[h] = t0L[h];
+                outR[h] = t0R[h];
+            }
+            stereoBlockSymmetric = stereoBlockSymmetric && outL[h] == outR[h];
+            if (vu)
+                vuPeak.process(outL[h], outR[h]);
+        }
+    }
+
+    /*
+     * The parallel modes whose filters never hear each other (FBBoth only without feedback,
+     * since its loop takes the blended output) can render each filter as its own task on the
+     * host's thread pool; see ParallelRender. The plugin drives it like processAudio, with
+     * beginParallel / planParallelBlock after each processControl / prepareParallelSample
+     * for each host sample / endParallel. Anything that rebuilds a filter or the oversampler
+     * flushes first, so work already recorded renders against the state it was recorded in.
+     */
+    template <RoutingModes mode, bool fb> static constexpr bool filtersIndependent()
+    {
+        return mode == RoutingModes::Parallel_FBEach || mode == RoutingModes::Parallel_FBOne ||
+               (mode == RoutingModes::Parallel_FBBoth && !fb);
+    }
+
+    std::unique_ptr<ParallelRender> parallelRender; // only when the host has a thread pool
+    const clap_host_thread_pool_t *hostThreadPool{nullptr};
+    void setupParallelRender(); // main thread, while deactivated
+
+    template <RoutingModes mode, bool fb, bool withOversampling>
+    void beginParallel(float *outL, float *outR)
+    {
+        static_assert(filtersIndependent<mode, fb>());
+        parallelTask = &Engine::renderParallelFilter<mode, fb, withOversampling>;
+        parallelJoin = &Engine::joinParallel<withOversampling>;
+        parallelRender->hostL = outL;
+        parallelRender->hostR = outR;
+        deferFilterControl = true;
+        // The join doesn't compare the sides, so nothing here may lead into a mono block
+        stereoBlockSymmetric = false;
+    }
+    void endParallel()
+    {
+        flushParallel();
+        deferFilterControl = false;
+    }
+    void flushParallel();
+    // The plugin's thread_pool exec, or inline when the host pool can't take the work.
+    void runParallelTask(uint32_t f) { (this->*parallelTask)((int)f); }
+
+    void planParallelBlock()
+    {
+        auto &pr = *parallelRender;
+        if (pr.numPlans == 0 || pr.plans[pr.numPlans - 1].at != pr.samples)
+            pr.numPlans++;
+        auto &pl = pr.plans[pr.numPlans - 1];
+        pl.at = pr.samples;
+        pl.control = true;
+        for (int f = 0; f < (int)numFilters; ++f)
+        {
+            pl.filter[f] = filterControl[f];
+            std::copy(std::begin(panMatrix[f]), std::end(panMatrix[f]), std::begin(pl.pan[f]));
+        }
+    }
+
+    template <bool withNoise, bool withOversampling>
+    void prepareParallelSample(float inL, float inR)
+    {
+        auto &pr = *parallelRender;
+        if (pr.numPlans == 0)
+        {
+            // Mid-block: the filters already have this block's control, so just carry the pan
+            auto &pl = pr.plans[pr.numPlans++];
+            pl.at = pr.samples;
+            pl.control = false;
+            for (int f = 0; f < (int)numFilters; ++f)
+                std::copy(std::begin(panMatrix[f]), std::end(panMatrix[f]),
+                          std::begin(pl.pan[f]));
+        }
+
+        auto prep = [&](float L, float R)
+        {
+            auto n = pr.samples++;
+            pr.dryL[n] = L;
+            pr.dryR[n] = R;
+
+            float inG = inGainLipol.v;
+            L *= inG;
+            R *= inG;
+
+            // Read the block's noise where the per sample path would, which skips it while
+            // stopped
+            if (withNoise && audioRunning)
+            {
+                float nsG = noiseGainLipol.v;
+                auto ni = noisePos++ & (BlockNoise::maxSamples - 1);
+                L += nsG * noise.values[0][ni];
+                R += nsG * noise.values[1][ni];
+            }
+            pr.inL[n] = L;
+            pr.inR[n] = R;
+
+            pr.blend1[n] = blendLipol1.v;
+            pr.blend2[n] = blendLipol2.v;
+            pr.fbLevel[n] = fbLevelLipol.v;
+            pr.mix[n] = mixLipol.v;
+            pr.outGain[n] = outGainLipol.v;
+            advanceRoutingLipols<withOversampling>();
+        };
+
+        if constexpr (withOversampling)
+        {
+            float inLU[2], inRU[2];
+            upsample(inL, inR, inLU, inRU);
+            prep(inLU[0], inRU[0]);
+            prep(inLU[1], inRU[1]);
+        }
+        else
+        {
+            prep(inL, inR);
+        }
+
+        if (pr.full())
+            flushParallel();
+    }
+
+    template <RoutingModes mode, bool fb, bool withOversampling> void renderParallelFilter(int f)
+    {
+        TF_TRACE_SCOPE("audio", "Engine::renderParallelFilter");
+        auto &pr = *parallelRender;
+
+        // FBEach feeds each filter back into itself; FBOne only the first
+        bool feeds = fb && (mode == RoutingModes::Parallel_FBEach || f == 0);
+        auto &fbSL = f == 0 ? fbL : fb2L;
+        auto &fbSR = f == 0 ? fbR : fb2R;
+
+        uint32_t nextPlan{0};
+        const sst::basic_blocks::dsp::pan_laws::panmatrix_t *pan{nullptr};
+        for (uint32_t n = 0; n < pr.samples; ++n)
+        {
+            if (nextPlan < pr.numPlans && pr.plans[nextPlan].at == n)
+            {
+                auto &pl = pr.plans[nextPlan++];
+                if (pl.control)
+                    applyFilterControl(f, pl.filter[f]);
+                pan = &pl.pan[f];
+            }
+
+            float oL{0}, oR{0};
+            if (audioRunning)
+            {
+                float iL{pr.inL[n]}, iR{pr.inR[n]};
+                if (fb && feeds)
+                {
+                    iL += fbSL;
+                    iR += fbSR;
+                }
+                processFilterSample(f, iL, iR, oL, oR);
+                applyPanMatrix(oL, oR, *pan);
+
+                if (fb && feeds)
+                {
+                    fbSL = sat(pr.fbLevel[n] * oL);
+                    fbSR = sat(pr.fbLevel[n] * oR);
+                }
+            }
+            pr.outL[f][n] = oL;
+            pr.outR[f][n] = oR;
+            advanceFadeLipol<withOversampling>(f);
+        }
+    }
+
+    template <bool withOversampling> void joinParallel()
+    {
+        auto &pr = *parallelRender;
+        auto join = [&](uint32_t n, float &outL, float &outR)
+        {
+            if (!audioRunning)
+            {
+                outL = 0;
+                outR = 0;
+                return;
+            }
+            outL = pr.blend1[n] * pr.outL[0][n] + pr.blend2[n] * pr.outL[1][n];
+            outR = pr.blend1[n] * pr.outR[0][n] + pr.blend2[n] * pr.outR[1][n];
+
+            auto mx = pr.mix[n];
+            auto outG = pr.outGain[n];
+
+            outL *= outG;
+            outR *= outG;
+
+            outL = mx * outL + (1.0 - mx) * pr.dryL[n];
+            outR = mx * outR + (1.0 - mx) * pr.dryR[n];
+
+            outL = std::clamp(outL, -2.5f, 2.5f);
+            outR = std::clamp(outR, -2.5f, 2.5f);
+        };
+
+        auto vu = meterThisBlock;
+        constexpr uint32_t step = withOversampling ? 2 : 1;
+        for (uint32_t n = 0; n < pr.samples; n += step)
+        {
+            auto &outL = *pr.hostL++;
+            auto &outR = *pr.hostR++;
+            if constexpr (withOversampling)
+            {
+                float outLU[2], outRU[2];
+                join(n, outLU[0], outRU[0]);
+                join(n + 1, outLU[1], outRU[1]);
+                downsample(outLU, outRU, outL, outR);
+            }
+            else
+            {
+                join(n, outL, outR);
+            }
+
+            if (vu)
+                vuPeak.process(outL, outR);
+        }
+    }
+
+    void (Engine::*parallelTask)(int){nullptr};
+    void (Engine::*parallelJoin)(){nullptr};
+
     void processUIQueue(const clap_output_events_t *);
 
     void handleParamValue(Param *p, uint32_t pid, float value);
@@ -338,6 +1182,11 @@ struct Engine
             UPDATE_VU,
             UPDATE_LFOSTEP,
             SEND_SAMPLE_RATE,
+#if TWOFILTERS_DSP_TIMING
+            // paramId is 0 for control, 1 for audio; then p50 / p99, and worst / count
+            UPDATE_DSP_TIMING,
+#endif
+            UPDATE_CPU_GOVERNOR, // paramId is the CpuGovernor::Level running, value the load
         } action;
         uint32_t paramId{0};
         float value{0}, value2{0};
@@ -355,21 +1204,47 @@ struct Engine
             STOP_AUDIO,
             START_AUDIO,
             SEND_POST_LOAD,
+            BEGIN_TRANSITION_LOAD, // uintValues[0] is the crossfade length in ms
+            SET_PARAM_FOR_TRANSITION,
+            END_TRANSITION_LOAD,
         } action;
         uint32_t paramId{0};
         float value{0};
         uint32_t uintValues[5]{0, 0, 0, 0, 0};
     };
-    using audioToMainQueue_t = sst::cpputils::SimpleRingBuffer<AudioToMainMsg, 1024 * 16>;
-    using mainToAudioQueue_T = sst::cpputils::SimpleRingBuffer<MainToAudioMsg, 1024 * 64>;
+#if TWOFILTERS_LOW_FOOTPRINT
+    // Still room for a whole patch load each way and a few hidden-editor frames of telemetry.
+    static constexpr size_t audioToMainCapacity{1024 * 4}, mainToAudioCapacity{1024 * 2};
+#else
+    static constexpr size_t audioToMainCapacity{1024 * 16}, mainToAudioCapacity{1024 * 64};
+#endif
+    using audioToMainQueue_t =
+        sst::cpputils::SimpleRingBuffer<AudioToMainMsg, audioToMainCapacity>;
+    using mainToAudioQueue_T =
+        sst::cpputils::SimpleRingBuffer<MainToAudioMsg, mainToAudioCapacity>;
     audioToMainQueue_t audioToMain;
     mainToAudioQueue_T mainToAudio;
+
+    // A SET_FILTER_MODEL for a filter that is still fading waits here until the fade ends,
+    // rather than cutting off the slot fading out. The latest one wins.
+    std::optional<MainToAudioMsg> queuedFilterModel[numFilters];
+    int32_t queuedLoadFadeBlocks[numFilters]{0, 0};
+    // loadFadeBlocks > 0 is a preset load's crossfade; 0 a single edit's
+    void setFilterModel(const MainToAudioMsg &msg, int32_t loadFadeBlocks);
     sst::basic_blocks::dsp::UIComponentLagHandler lagHandler;
 
     // Threading / ownership coordination (see .claude/patch-to-main-plan.md)
     std::atomic<bool> editorActive{false}; // set by the editor; unified editor-open flag
     std::atomic<bool> mainThreadDrainRequested{false}; // coalesces request_callback
     std::atomic<uint32_t> uiForceRebuild{0}; // bump => open editor rebuilds from patchMain
+    std::atomic<bool> telemetryAvailable{false}; // set after any audioToMain push; the editor
+                                                 // idle only drains when it is set
+
+    void pushToMain(const AudioToMainMsg &m)
+    {
+        audioToMain.push(m);
+        telemetryAvailable.store(true, std::memory_order_release);
+    }
 
     // Applies a patch-model audioToMain message (a host-automation param value) to `dest`.
     // Returns true if handled, false for UI-only telemetry (VU/LFO/sample-rate) which the
@@ -382,6 +1257,15 @@ struct Engine
     // UI-only messages. Used when no editor is open.
     void drainAudioToMainInto(Patch &dest);
 
+    // Approximate bytes held by this instance, by subsystem, for the debug panel and tests.
+    // Library objects count at their sizeof; the patches add an estimate of their heap.
+    struct MemoryReport
+    {
+        std::vector<std::pair<std::string, size_t>> entries;
+        size_t total() const;
+    };
+    MemoryReport memoryReport() const;
+
     // Main-thread paramsFlush: apply incoming host events in place to patchMain and
     // echo queued UI edits to the host. Never touches `patch`.
     void paramsFlushMainThread(const clap_input_events_t *in, const clap_output_events_t *out);
@@ -391,9 +1275,12 @@ struct Engine
     // thread only. Patch name/dirty are main-thread-only state; the caller sets them on
     // patchMain directly, they do not travel to the audio patch. Static because callers
     // (preset manager, clap adapter) hold the queue + host but not an Engine handle.
+    // With transitionMs > 0 the load never stops audio: values glide on the param lags,
+    // LFOs keep their phase, unchanged filters keep their state and changed ones crossfade.
     static void sendEntirePatchToAudio(Patch &src, mainToAudioQueue_T &mainToAudio,
                                        const clap_host_t *host,
-                                       const clap_host_params_t *hostPar = nullptr);
+                                       const clap_host_params_t *hostPar = nullptr,
+                                       int32_t transitionMs = 0);
 
     void snapAllParams()
     {
@@ -417,17 +1304,39 @@ struct Engine
 
     bool activeFilter[2]{true, true};
     void setupFilter(int instance);
+    void setupFilterSlot(int slot, int instance);
+    // A stereo instance, or with quad one lane per poly voice
+    void configureFilter(sst::filtersplusplus::Filter &flt, sst::filtersplusplus::FilterModel model,
+                         const sst::filtersplusplus::ModelConfig &cfg, combDelay_t *delays,
+                         bool quad = false);
+    static void configureFilter(sst::filtersplusplus::Filter &flt,
+                                sst::filtersplusplus::FilterModel model,
+                                const sst::filtersplusplus::ModelConfig &cfg, combDelay_t *delays,
+                                double sampleRate, uint32_t blockSamples, bool quad = false);
 
     void onMainThread();
 
     sst::cpputils::active_set_overlay<Param> paramLagSet;
 
     sst::basic_blocks::dsp::VUPeak vuPeak;
+    // Set by processControl: the editor is open, and with low telemetry, one block in four
+    bool meterThisBlock{false};
+    uint32_t meterBlockCount{0};
     int32_t updateVuEvery{(int32_t)(48000 * 2.5 / 60 / blockSize)}; // approx
     int32_t lastVuUpdate{updateVuEvery};
 
-    float combDelays[2][4][sst::filters::utilities::MAX_FB_COMB +
-                           sst::filters::utilities::SincTable::FIRipol_N];
+    DspTiming dspTiming;
+#if TWOFILTERS_DSP_TIMING
+    // Summarise and reset about once a second, piggybacking on the VU cadence.
+    static constexpr int32_t vuUpdatesPerTimingReport{24};
+    int32_t vuUpdatesSinceTimingReport{0};
+    void sendDspTiming();
+#endif
+    // Last telemetry sent, so an unchanged VU or LFO (silence, a stopped LFO) costs the
+    // editor nothing.
+    float lastSentVu[2]{-1.f, -1.f};
+    float lastSentLfo[3][2]{{-1.f, -1.f}, {-1.f, -1.f}, {-1.f, -1.f}};
+
 
     const clap_host_t *clapHost{nullptr};
 };
@@ -0,0 +1,59 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_FILTER_UNIT_H
+#define BACONPAUL_TWOFILTERS_ENGINE_FILTER_UNIT_H
+
+#include <cstdint>
+
+#include "sst/filters++.h"
+
+#include "engine/poly-voices.h"
+
+namespace baconpaul::twofilters
+{
+/*
+ * One filter slot's filter and the comb delay lines it was handed, on the heap so a whole
+ * unit can change hands by pointer. A model change from the editor is prepared as a unit on
+ * the main thread and passed to the audio thread through Engine::standbyFilter; the unit it
+ * displaces goes back through Engine::retiredFilters, so the audio thread neither prepares
+ * nor frees one.
+ *
+ * A standby unit records what it was prepared for. Should the audio thread's setup have
+ * moved on by the time it arrives (oversampling, the control block, the sample rate), it
+ * doesn't match and the audio thread sets the slot up itself as before.
+ */
+struct FilterUnit
+{
+    sst::filtersplusplus::Filter filter;
+    combDelay_t delays[4]{};
+
+    sst::filtersplusplus::FilterModel model{sst::filtersplusplus::FilterModel::None};
+    sst::filtersplusplus::ModelConfig config{};
+    double sampleRate{0};
+    uint32_t blockSamples{0};
+
+    // Links Engine::retireBacklog while the retire ring is full
+    FilterUnit *nextRetired{nullptr};
+
+    bool preparedFor(sst::filtersplusplus::FilterModel m,
+                     const sst::filtersplusplus::ModelConfig &c, double sr, uint32_t bs) const
+    {
+        return model == m && config.pt == c.pt && config.st == c.st && config.dt == c.dt &&
+               config.mt == c.mt && sampleRate == sr && blockSamples == bs;
+    }
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_FILTER_UNIT_H
@@ -0,0 +1,128 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_LINEAR_PHASE_HALFBAND_H
+#define BACONPAUL_TWOFILTERS_ENGINE_LINEAR_PHASE_HALFBAND_H
+
+#include <array>
+#include <cmath>
+
+#include "engine/dsp-kernels.h"
+
+namespace baconpaul::twofilters
+{
+/*
+ * A linear phase stand-in for sst::filters::HalfRate::HalfRateFilter in the 2x oversampler,
+ * with the same process_sample_U2 / process_sample_D2 calls. It is a Blackman-Harris
+ * windowed sinc halfband FIR, so all the taps an even distance from the centre (bar the
+ * centre itself) are zero and each output is one short dot product. An up / down pair
+ * delays every frequency by exactly `latency` base rate samples; the IIR pair is shorter
+ * but its delay varies with frequency.
+ */
+struct LinearPhaseHalfBand
+{
+    static constexpr int numTaps{63}; // 4k + 3, so the centre tap falls on an odd index
+    static constexpr int centre{(numTaps - 1) / 2};
+    static constexpr int numSide{(numTaps + 1) / 2}; // the even index taps
+    static constexpr int latency{centre};            // of an up / down pair, at the base rate
+
+    void reset() { channels = {}; }
+
+    void process_sample_U2(float inL, float inR, float *outL, float *outR)
+    {
+        up(channels[0], inL, outL);
+        up(channels[1], inR, outR);
+    }
+
+    void process_sample_D2(const float *inL, const float *inR, float &outL, float &outR)
+    {
+        outL = down(channels[0], inL);
+        outR = down(channels[1], inR);
+    }
+
+    // The left channel alone, for mono input. Call copyLeftToRight before going back to
+    // stereo, so the right history catches up.
+    void process_sample_U2(float in, float *out) { up(channels[0], in, out); }
+    void process_sample_D2(const float *in, float &out) { out = down(channels[0], in); }
+    void copyLeftToRight() { channels[1] = channels[0]; }
+
+    // h[2j], normalised so the whole filter has unity gain at DC
+    static const std::array<float, numSide> &sideTaps()
+    {
+        static const auto taps = []()
+        {
+            constexpr double pi{3.14159265358979323846};
+            std::array<float, numSide> res{};
+            double sum{0};
+            for (int j = 0; j < numSide; ++j)
+            {
+                auto k = 2 * j;
+                auto x = 0.5 * (k - centre); // never zero, since the centre is odd
+                auto ph = 2 * pi * k / (numTaps - 1);
+                auto w = 0.35875 - 0.48829 * std::cos(ph) + 0.14128 * std::cos(2 * ph) -
+                         0.01168 * std::cos(3 * ph);
+                res[j] = (float)(0.5 * std::sin(pi * x) / (pi * x) * w);
+                sum += res[j];
+            }
+            for (auto &t : res)
+                t = (float)(t * 0.5 / sum);
+            return res;
+        }();
+        return taps;
+    }
+
+  private:
+    // Doubled ring, so the newest numSide values are always contiguous, newest first
+    struct History
+    {
+        float v[2 * numSide]{};
+        int pos{0};
+        void push(float x)
+        {
+            pos = (pos == 0 ? numSide : pos) - 1;
+            v[pos] = x;
+            v[pos + numSide] = x;
+        }
+        const float *newestFirst() const { return v + pos; }
+    };
+    struct Channel
+    {
+        History a, b;
+    };
+    std::array<Channel, 2> channels{};
+
+    static_assert(numSide % 16 == 0, "DspKernels::dot works in sixteens");
+    static float dot(const float *x) { return dspKernels().dot(sideTaps().data(), x, numSide); }
+
+    // Zero stuffing with a gain of two: the even outputs see the side taps, the odd ones
+    // only the centre tap, which is a plain delay.
+    static void up(Channel &c, float in, float *out)
+    {
+        c.a.push(in);
+        auto *x = c.a.newestFirst();
+        out[0] = 2 * dot(x);
+        out[1] = x[(centre - 1) / 2];
+    }
+
+    // Even inputs go through the side taps, odd ones through the centre tap's delay.
+    static float down(Channel &c, const float *in)
+    {
+        c.a.push(in[0]);
+        c.b.push(in[1]);
+        return dot(c.a.newestFirst()) + 0.5f * c.b.newestFirst()[(centre + 1) / 2];
+    }
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_LINEAR_PHASE_HALFBAND_H
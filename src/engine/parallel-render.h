@@ -0,0 +1,75 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_PARALLEL_RENDER_H
+#define BACONPAUL_TWOFILTERS_ENGINE_PARALLEL_RENDER_H
+
+#include <array>
+#include <cstdint>
+
+#include "sst/basic-blocks/dsp/PanLaws.h"
+
+#include "configuration.h"
+
+namespace baconpaul::twofilters
+{
+// What processControl decides for one filter for one block. Morphs are already mapped for
+// bipolar models, so applying it doesn't need the patch.
+struct FilterControl
+{
+    float cutoff{0}, resonance{0}, morph{0}, fadeMorph{0};
+};
+
+/*
+ * Scratch for rendering the two filters of a parallel mode as two tasks, which the engine
+ * hands to the host's CLAP thread pool. The audio thread runs control as usual, but instead
+ * of touching the filters it records each block's FilterControl and pan here, along with
+ * each sample's filter input (after gain and noise) and the routing gains the per sample
+ * path reads from its lipols. Each task then runs one filter, with its own feedback and
+ * pan, across the whole stretch, and the audio thread joins the two for blend and mix.
+ *
+ * Everything is in filter-rate samples, so twice the host samples when oversampling.
+ */
+struct ParallelRender
+{
+#if TWOFILTERS_LOW_FOOTPRINT
+    static constexpr uint32_t maxBlocks{16};
+#else
+    static constexpr uint32_t maxBlocks{64};
+#endif
+    static constexpr uint32_t capacity{maxBlocks * blockSize * 2};
+
+    struct BlockPlan
+    {
+        uint32_t at{0};       // the sample the block's control lands on
+        bool control{false};  // false for the pan carried into a stretch that starts mid-block
+        FilterControl filter[numFilters];
+        sst::basic_blocks::dsp::pan_laws::panmatrix_t pan[numFilters];
+    };
+    std::array<BlockPlan, capacity / blockSize + 2> plans;
+    uint32_t numPlans{0}, samples{0};
+
+    bool full() const { return samples + 2 > capacity || numPlans + 1 >= plans.size(); }
+
+    float dryL[capacity], dryR[capacity], inL[capacity], inR[capacity];
+    float blend1[capacity], blend2[capacity], fbLevel[capacity], mix[capacity],
+        outGain[capacity];
+    float outL[numFilters][capacity], outR[numFilters][capacity];
+
+    // Where the next joined host-rate sample is written
+    float *hostL{nullptr}, *hostR{nullptr};
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_PARALLEL_RENDER_H
@@ -71,8 +71,14 @@ struct Patch : pats::PatchBase<Patch, Param>
 
     static constexpr uint32_t floatFlags{CLAP_PARAM_IS_AUTOMATABLE};
     static constexpr uint32_t boolFlags{CLAP_PARAM_IS_AUTOMATABLE | CLAP_PARAM_IS_STEPPED};
+    // The filter params a note can modulate in poly mode; see Engine::paramModulation
+    static constexpr uint32_t noteModFlags{
+        floatFlags | CLAP_PARAM_IS_MODULATABLE | CLAP_PARAM_IS_MODULATABLE_PER_NOTE_ID |
+        CLAP_PARAM_IS_MODULATABLE_PER_KEY | CLAP_PARAM_IS_MODULATABLE_PER_CHANNEL |
+        CLAP_PARAM_IS_MODULATABLE_PER_PORT};
 
     static md_t floatMd() { return md_t().asFloat().withFlags(floatFlags); }
+    static md_t floatNoteModMd() { return md_t().asFloat().withFlags(noteModFlags); }
     static md_t floatEnvRateMd()
     {
         return md_t().asFloat().withFlags(floatFlags).as25SecondExpTime();
@@ -81,68 +87,23 @@ struct Patch : pats::PatchBase<Patch, Param>
     static md_t boolMdNoAuto() { return md_t().asBool().withFlags(CLAP_PARAM_IS_STEPPED); }
     static md_t intMd() { return md_t().asInt().withFlags(boolFlags); }
 
-    Patch() : pats::PatchBase<Patch, Param>()
-
+    /*
+     * Every Patch has the same metadata and param order, so both are built once in a
+     * prototype and each Patch copies its nodes from there rather than building ~150
+     * ParamMetaData and their names again. The copies are still held per Param, as
+     * ParamBase keeps its metadata by value; Engine::memoryReport lists what they cost.
+     */
+    Patch()
+        : pats::PatchBase<Patch, Param>(),
+          filterNodes{prototype().filterNodes[0], prototype().filterNodes[1]},
+          routingNode(prototype().routingNode),
+          stepLfoNodes{prototype().stepLfoNodes[0], prototype().stepLfoNodes[1]}
     {
-        onResetToInit = [](auto &patch)
-        {
-            for (auto &fn : patch.filterNodes)
-            {
-                fn.model = sst::filtersplusplus::FilterModel::None;
-                fn.config = {};
-            }
-        };
-        auto pushParams = [this](auto &from) { this->pushMultipleParams(from.params()); };
-
-        filterNodes[0].model = sst::filtersplusplus::FilterModel::CytomicSVF;
-        filterNodes[0].config.pt = sst::filtersplusplus::Passband::LP;
-
-        filterNodes[1].model = sst::filtersplusplus::FilterModel::None;
-        filterNodes[1].config = {};
-
-        pushParams(filterNodes[0]);
-        pushParams(filterNodes[1]);
-        pushParams(routingNode);
-
-        pushParams(stepLfoNodes[0]);
-        pushParams(stepLfoNodes[1]);
-
-        std::sort(params.begin(), params.end(),
-                  [](const Param *a, const Param *b)
-                  {
-                      auto ga = a->meta.groupName;
-                      auto gb = b->meta.groupName;
-                      if (ga != gb)
-                      {
-                          if (ga == "Main")
-                              return true;
-                          if (gb == "Main")
-                              return false;
-
-                          return ga < gb;
-                      }
-
-                      auto an = a->meta.name;
-                      auto bn = b->meta.name;
-                      auto ane = an.find("Env ") != std::string::npos;
-                      auto bne = bn.find("Env ") != std::string::npos;
-
-                      if (ane != bne)
-                      {
-                          if (ane)
-                              return false;
-
-                          return true;
-                      }
-                      if (ane && bne)
-                          return a->meta.id < b->meta.id;
-
-                      return a->meta.name < b->meta.name;
-                  });
+        setupParams();
 
-        additionalToState = [this](auto &state) { additionalToStateImpl(state); };
-        additionalFromState = [this](auto *state, auto ver)
-        { additionalFromStateImpl(state, ver); };
+        const auto &order = prototype().params;
+        for (size_t i = 0; i < order.size(); ++i)
+            params[i] = paramMap.at(order[i]->meta.id);
     }
 
     struct FilterNode
@@ -151,17 +112,17 @@ struct Patch : pats::PatchBase<Patch, Param>
         static constexpr uint32_t idStride{100};
 
         FilterNode(int instance)
-            : cutoff(floatMd()
+            : cutoff(floatNoteModMd()
                          .asAudibleFrequency()
                          .withGroupName(groupName(instance))
                          .withName("Cutoff " + std::to_string(instance + 1))
                          .withID(id(instance, 0))),
-              resonance(floatMd()
+              resonance(floatNoteModMd()
                             .asPercent()
                             .withGroupName(groupName(instance))
                             .withName("Resonance " + std::to_string(instance + 1))
                             .withID(id(instance, 1))),
-              morph(floatMd()
+              morph(floatNoteModMd()
                         .asPercent()
                         .withGroupName(groupName(instance))
                         .withName("Morph " + std::to_string(instance + 1))
@@ -172,7 +133,7 @@ struct Patch : pats::PatchBase<Patch, Param>
                          .withGroupName(groupName(instance))
                          .withName("Active " + std::to_string(instance + 1))
                          .withID(id(instance, 3))),
-              pan(floatMd()
+              pan(floatNoteModMd()
                       .asPan()
                       .withGroupName(groupName(instance))
                       .withName("Pan " + std::to_string(instance + 1))
@@ -281,7 +242,43 @@ struct Patch : pats::PatchBase<Patch, Param>
                                       .withCustomDefaultDisplay("F1 + F2")
                                       .withCustomMaxDisplay("F2")
                                       .withCustomMinDisplay("F1")
-                                      .withID(id(11)))
+                                      .withID(id(11))),
+              oversamplePhase(md_t()
+                                  .asInt()
+                                  .withFlags(CLAP_PARAM_IS_STEPPED)
+                                  .withRange(0, 1)
+                                  .withDefault(0)
+                                  .withGroupName("Routing")
+                                  .withName("Oversample Phase")
+                                  .withID(id(12))
+                                  .withUnorderedMapFormatting(
+                                      {{0, "Low Latency"}, {1, "Linear Phase"}})),
+              feedbackEco(boolMdNoAuto()
+                              .asOnOffBool()
+                              .withGroupName("Routing")
+                              .withName("Feedback Eco")
+                              .withID(id(13))),
+              polyphony(boolMdNoAuto()
+                            .asOnOffBool()
+                            .withGroupName("Routing")
+                            .withName("Poly")
+                            .withID(id(14))),
+              keytrack(floatMd()
+                           .asPercent()
+                           .withDefault(1.0)
+                           .withGroupName("Routing")
+                           .withName("Key Track")
+                           .withID(id(15))),
+              cpuGovernor(boolMdNoAuto()
+                              .asOnOffBool()
+                              .withGroupName("Routing")
+                              .withName("CPU Governor")
+                              .withID(id(16))),
+              offlineQuality(boolMdNoAuto()
+                                 .asOnOffBool()
+                                 .withGroupName("Routing")
+                                 .withName("Offline Quality")
+                                 .withID(id(17)))
         {
         }
 
@@ -293,13 +290,18 @@ struct Patch : pats::PatchBase<Patch, Param>
         Param inputGain, outputGain;
         Param noiseLevel, noisePower;
         Param oversample, filterBlendSerial, filterBlendParallel;
+        Param oversamplePhase, feedbackEco;
+        Param polyphony, keytrack;
+        Param cpuGovernor, offlineQuality;
 
         std::vector<Param *> params()
         {
             std::vector<Param *> res{
-                &feedback,   &feedbackPower, &routingMode,       &retriggerMode,
-                &mix,        &inputGain,     &outputGain,        &noiseLevel,
-                &noisePower, &oversample,    &filterBlendSerial, &filterBlendParallel};
+                &feedback,        &feedbackPower, &routingMode,       &retriggerMode,
+                &mix,             &inputGain,     &outputGain,        &noiseLevel,
+                &noisePower,      &oversample,    &filterBlendSerial, &filterBlendParallel,
+                &oversamplePhase, &feedbackEco,   &polyphony,         &keytrack,
+                &cpuGovernor,     &offlineQuality};
             return res;
         }
     } routingNode;
@@ -466,6 +468,92 @@ struct Patch : pats::PatchBase<Patch, Param>
 
     void additionalToStateImpl(TiXmlElement &root);
     void additionalFromStateImpl(TiXmlElement *root, uint32_t version);
+
+  private:
+    struct BuildMetadata
+    {
+    };
+
+    // The prototype: the nodes build their metadata, and the params are sorted by group and
+    // name for the host and the editor
+    explicit Patch(BuildMetadata) : pats::PatchBase<Patch, Param>()
+    {
+        filterNodes[0].model = sst::filtersplusplus::FilterModel::CytomicSVF;
+        filterNodes[0].config.pt = sst::filtersplusplus::Passband::LP;
+
+        filterNodes[1].model = sst::filtersplusplus::FilterModel::None;
+        filterNodes[1].config = {};
+
+        setupParams();
+
+        std::sort(params.begin(), params.end(),
+                  [](const Param *a, const Param *b)
+                  {
+                      const auto &ga = a->meta.groupName;
+                      const auto &gb = b->meta.groupName;
+                      if (ga != gb)
+                      {
+                          if (ga == "Main")
+                              return true;
+                          if (gb == "Main")
+                              return false;
+
+                          return ga < gb;
+                      }
+
+                      const auto &an = a->meta.name;
+                      const auto &bn = b->meta.name;
+                      auto ane = an.find("Env ") != std::string::npos;
+                      auto bne = bn.find("Env ") != std::string::npos;
+
+                      if (ane != bne)
+                      {
+                          if (ane)
+                              return false;
+
+                          return true;
+                      }
+                      if (ane && bne)
+                          return a->meta.id < b->meta.id;
+
+                      return a->meta.name < b->meta.name;
+                  });
+    }
+
+    static const Patch &prototype()
+    {
+        static const Patch proto{BuildMetadata{}};
+        return proto;
+    }
+
+    // What each instance wires to itself
+    void setupParams()
+    {
+        onResetToInit = [](auto &patch)
+        {
+            for (auto &fn : patch.filterNodes)
+            {
+                fn.model = sst::filtersplusplus::FilterModel::None;
+                fn.config = {};
+            }
+        };
+        auto pushParams = [this](auto &from) { this->pushMultipleParams(from.params()); };
+
+        pushParams(filterNodes[0]);
+        pushParams(filterNodes[1]);
+        pushParams(routingNode);
+
+        pushParams(stepLfoNodes[0]);
+        pushParams(stepLfoNodes[1]);
+
+        // Copied Params still point at the prototype's partners; no param pairs up today
+        for (auto *p : params)
+            p->tempoSyncPartner = nullptr;
+
+        additionalToState = [this](auto &state) { additionalToStateImpl(state); };
+        additionalFromState = [this](auto *state, auto ver)
+        { additionalFromStateImpl(state, ver); };
+    }
 };
 } // namespace baconpaul::twofilters
 #endif // PATCH_H
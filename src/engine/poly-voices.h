@@ -0,0 +1,206 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_POLY_VOICES_H
+#define BACONPAUL_TWOFILTERS_ENGINE_POLY_VOICES_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+#include "sst/basic-blocks/dsp/BlockInterpolators.h"
+#include "sst/basic-blocks/dsp/PanLaws.h"
+#include "sst/basic-blocks/modulators/StepLFO.h"
+#include "sst/filters++.h"
+#include "sst/voicemanager/voicemanager.h"
+
+#include "configuration.h"
+
+namespace baconpaul::twofilters
+{
+// One comb delay line, as filters++ is handed them
+using combDelay_t = float[sst::filters::utilities::MAX_FB_COMB +
+                          sst::filters::utilities::SincTable::FIRipol_N];
+
+// The params a note can modulate on its own, per filter
+enum PolyModTarget
+{
+    modCutoff,
+    modResonance,
+    modMorph,
+    modPan,
+    numPolyModTargets
+};
+
+struct PolyVoice
+{
+    bool active{false}, gateOn{false};
+    int16_t port{-1}, channel{-1}, key{-1};
+    int32_t noteId{-1};
+
+    float gateLevel{0}; // where the gate ramp is heading this block
+    uint32_t settleBlocks{0}; // once ended, blocks left for its lane to ring down
+    sst::basic_blocks::dsp::lipol<float, blockSize, true> gate;
+    float fb{0}, fb2{0}; // mono loops, as the voice input is mono
+    float mod[numFilters][numPolyModTargets]{};
+    sst::basic_blocks::dsp::pan_laws::panmatrix_t pan[numFilters];
+    std::array<sst::basic_blocks::modulators::StepLFO<blockSize>, numStepLFOs> lfos;
+
+    // CLAP matching, for chokes: a note id wins, otherwise -1 is a wildcard
+    bool matches(int16_t p, int16_t c, int16_t k, int32_t n) const
+    {
+        if (n != -1)
+            return noteId == n;
+        return (p == -1 || port == p) && (c == -1 || channel == c) && (k == -1 || key == k);
+    }
+};
+
+struct Engine;
+
+/*
+ * Poly mode. Each note gets a mono voice running its own pair of filters, keytracked and
+ * with its own step LFO phase, on the mid of the input. filters++ runs its four SIMD lanes
+ * as one instance, so voices are packed four to a quad instance, a lane each with its own
+ * coefficients. Routing, blend and feedback work as in stereo, per voice; each voice pans
+ * its two filters itself and the voices sum into the output.
+ *
+ * filters++ resets an instance as a whole, so a lane can't be cleared under its neighbours.
+ * Instead an ended voice's lane runs on silence, with no feedback and damped coefficients,
+ * for settleSeconds before it is handed out again; there is a spare pack so a steal can
+ * still find a settled lane. Only under heavier churn than that does a lane go out early.
+ *
+ * sst-voicemanager owns the notes: it matches note offs and per note modulation (CLAP
+ * wildcards included) and picks what to steal once all maxVoices sound. The engine only
+ * finds each voice it starts a free slot, through the responder, and tells the manager
+ * when a voice's gate has closed.
+ *
+ * Allocated on activate, as it carries its own filters and comb lines.
+ */
+struct PolyVoices
+{
+    static constexpr int maxVoices{16};
+    static constexpr int lanes{4}; // voices per quad filter instance
+    static constexpr int numPacks{maxVoices / lanes + 1};
+    static constexpr int numSlots{numPacks * lanes};
+    static constexpr float gateSeconds{0.005f};   // the attack and release ramp
+    static constexpr float settleSeconds{0.05f}; // a free lane's ring down, combs included
+
+    std::array<PolyVoice, numSlots> voices;
+    std::array<std::array<sst::filtersplusplus::Filter, numFilters>, numPacks> filters;
+    combDelay_t combDelays[numPacks][numFilters][4];
+
+    // Voices that ended since the last control block, for the host's CLAP_EVENT_NOTE_END
+    struct NoteEnd
+    {
+        int16_t port, channel, key;
+        int32_t noteId;
+    };
+    std::array<NoteEnd, numSlots * 2> pendingEnds;
+    uint32_t numPendingEnds{0};
+
+    static_assert(maxVoices % lanes == 0);
+
+    static int packOf(int v) { return v / lanes; }
+    static int laneOf(int v) { return v % lanes; }
+    int indexOf(const PolyVoice *v) const { return (int)(v - voices.data()); }
+    // Sounding, or still ringing down
+    bool packActive(int p) const
+    {
+        for (int l = 0; l < lanes; ++l)
+        {
+            auto &v = voices[p * lanes + l];
+            if (v.active || v.settleBlocks > 0)
+                return true;
+        }
+        return false;
+    }
+
+    struct VMConfig
+    {
+        static constexpr size_t maxVoiceCount{maxVoices};
+        using voice_t = PolyVoice;
+    };
+    using beginBuffer_t = sst::voicemanager::VoiceBeginBufferEntry<VMConfig>::buffer_t;
+    using initInstructions_t = sst::voicemanager::VoiceInitInstructionsEntry<VMConfig>::buffer_t;
+    using initBuffer_t = sst::voicemanager::VoiceInitBufferEntry<VMConfig>::buffer_t;
+
+    // The engine side of sst-voicemanager; defined with the rest of poly mode in engine.cpp
+    struct VMResponder
+    {
+        Engine &engine;
+        std::function<void(PolyVoice *)> voiceEndCallback{[](auto) {}};
+        void setVoiceEndCallback(std::function<void(PolyVoice *)> f) { voiceEndCallback = f; }
+
+        int32_t beginVoiceCreationTransaction(beginBuffer_t &buffer, uint16_t port,
+                                              uint16_t channel, uint16_t key, int32_t noteId,
+                                              float velocity);
+        int32_t initializeMultipleVoices(int32_t voiceCount,
+                                         const initInstructions_t &instructions,
+                                         initBuffer_t &working, uint16_t port, uint16_t channel,
+                                         uint16_t key, int32_t noteId, float velocity,
+                                         float retune);
+        void endVoiceCreationTransaction(uint16_t, uint16_t, uint16_t, int32_t, float) {}
+
+        void releaseVoice(PolyVoice *v, float) { v->gateOn = false; }
+        void terminateVoice(PolyVoice *v);
+        void retriggerVoiceWithNewNoteID(PolyVoice *v, int32_t noteId, float);
+        void moveVoice(PolyVoice *v, uint16_t port, uint16_t channel, uint16_t key, float);
+        void moveAndRetriggerVoice(PolyVoice *v, uint16_t port, uint16_t channel, uint16_t key,
+                                   float velocity);
+        void discardHostVoice(int32_t) {}
+
+        void setVoicePolyphonicParameterModulation(PolyVoice *v, uint32_t parameter,
+                                                   double value);
+        void setVoiceMonophonicParameterModulation(PolyVoice *, uint32_t, double) {}
+        void setNoteExpression(PolyVoice *, int32_t, double) {}
+        void setPolyphonicAftertouch(PolyVoice *, int8_t) {}
+    };
+    // Pitch bend, CCs and pressure don't reach the filters
+    struct VMMonoResponder
+    {
+        void setMIDIPitchBend(int16_t, int16_t) {}
+        void setMIDI1CC(int16_t, int16_t, int8_t) {}
+        void setMIDIChannelPressure(int16_t, int16_t) {}
+    };
+    using voiceManager_t =
+        sst::voicemanager::VoiceManager<VMConfig, VMResponder, VMMonoResponder>;
+
+    VMResponder responder;
+    VMMonoResponder monoResponder;
+    voiceManager_t voiceManager;
+
+    explicit PolyVoices(Engine &e) : responder{e}, voiceManager(responder, monoResponder)
+    {
+        voiceManager.setPolyphonyGroupVoiceLimit(0, maxVoices);
+    }
+
+    // A settled slot, else the one closest to settling
+    int freeVoice() const
+    {
+        int res{-1};
+        for (int v = 0; v < numSlots; ++v)
+        {
+            if (voices[v].active)
+                continue;
+            if (voices[v].settleBlocks == 0)
+                return v;
+            if (res < 0 || voices[v].settleBlocks < voices[res].settleBlocks)
+                res = v;
+        }
+        return res;
+    }
+};
+} // namespace baconpaul::twofilters
+#endif // BACONPAUL_TWOFILTERS_ENGINE_POLY_VOICES_H
@@ -97,5 +97,17 @@ inline StepLFOSongPos stepLFOSongPos(double timeInBeats, double barStartBeats, d
     r.phase = phase;
     return r;
 }
+
+/*
+ * The LFO's value at (step, phase). setPhaseTo only places the LFO, so a process of no
+ * samples follows to work out its output there without moving it. The step editor samples
+ * its preview this way, a segment at a time.
+ */
+template <typename LFO> float stepLFOValueAt(LFO &lfo, float rate, int step, float phase)
+{
+    lfo.setPhaseTo(step, phase);
+    lfo.process(rate, 0, true, false, 0);
+    return lfo.output;
+}
 } // namespace baconpaul::twofilters
 #endif // BACONPAUL_TWOFILTERS_ENGINE_STEPLFO_SONGPOS_H
@@ -0,0 +1,107 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "trace-recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include "configuration.h"
+
+namespace baconpaul::twofilters
+{
+std::atomic<bool> TraceRecorder::recording{false};
+std::atomic<TraceRecorder::Ring *> TraceRecorder::pool{nullptr};
+std::atomic<size_t> TraceRecorder::claimed{0};
+std::atomic<uint64_t> TraceRecorder::startedAt{0};
+
+uint64_t TraceRecorder::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void TraceRecorder::start()
+{
+    // The pool lives for the rest of the process, so a thread's ring pointer never dangles.
+    if (!pool.load())
+        pool.store(new Ring[maxThreads]);
+    startedAt = now();
+    recording = true;
+}
+
+void TraceRecorder::record(const char *cat, const char *name, uint64_t start, uint64_t end)
+{
+    thread_local Ring *ring{nullptr};
+    if (!ring)
+    {
+        auto *p = pool.load(std::memory_order_acquire);
+        if (!p || claimed.load(std::memory_order_relaxed) >= maxThreads)
+            return;
+        auto idx = claimed.fetch_add(1);
+        if (idx >= maxThreads)
+            return;
+        ring = &p[idx];
+    }
+
+    auto w = ring->written.load(std::memory_order_relaxed);
+    ring->spans[w & (ringSize - 1)] = {cat, name, start, end};
+    ring->written.store(w + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::dumpChromeJson(const fs::path &to)
+{
+    recording = false;
+    auto *p = pool.load();
+    if (!p)
+        return false;
+
+    std::ofstream o(to);
+    if (!o.is_open())
+    {
+        SQLOG("Unable to write trace to " << to.u8string());
+        return false;
+    }
+
+    // A writer that was mid-span when recording stopped may still land one more; spans
+    // are only read up to the count published before we got here.
+    auto t0 = startedAt.load();
+    auto threads = std::min(claimed.load(), maxThreads);
+    o << "{\"traceEvents\":[\n";
+    bool first{true};
+    for (size_t t = 0; t < threads; ++t)
+    {
+        auto &r = p[t];
+        auto n = r.written.load(std::memory_order_acquire);
+        auto from = n > ringSize ? n - ringSize : 0;
+        for (auto i = from; i < n; ++i)
+        {
+            const auto &s = r.spans[i & (ringSize - 1)];
+            if (!s.name || s.start < t0 || s.end < s.start)
+                continue;
+            o << (first ? "" : ",\n")
+              << fmt::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},"
+                             "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                             s.name, s.cat, (s.start - t0) / 1000.0,
+                             (s.end - s.start) / 1000.0, t);
+            first = false;
+        }
+    }
+    o << "\n]}\n";
+    return true;
+}
+} // namespace baconpaul::twofilters
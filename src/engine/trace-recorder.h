@@ -0,0 +1,94 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_ENGINE_TRACE_RECORDER_H
+#define BACONPAUL_TWOFILTERS_ENGINE_TRACE_RECORDER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "filesystem/import.h"
+
+namespace baconpaul::twofilters
+{
+/*
+ * Process-wide span recorder for diagnosing cross-thread stalls. Off until start(); while
+ * off a TF_TRACE_SCOPE costs one relaxed atomic load. start() allocates a fixed pool of
+ * rings once, and each thread claims one on its first span with a fetch_add, so recording
+ * never allocates or locks and is safe on the audio thread. Rings overwrite their oldest
+ * spans, and a thread that finds the pool exhausted just goes unrecorded.
+ *
+ * dumpChromeJson stops recording and writes the spans since start() in the Chrome trace
+ * event format, which chrome://tracing and ui.perfetto.dev both load.
+ *
+ * Names and categories must be string literals; only the pointers are stored.
+ */
+struct TraceRecorder
+{
+    static constexpr size_t ringSize{1 << 14}; // spans per thread, a power of two
+    static constexpr size_t maxThreads{16};
+
+    static bool isRecording() { return recording.load(std::memory_order_relaxed); }
+    static uint64_t now();
+
+    static void start(); // main thread
+    static bool dumpChromeJson(const fs::path &to);
+
+    static void record(const char *cat, const char *name, uint64_t start, uint64_t end);
+
+  private:
+    struct Span
+    {
+        const char *cat{nullptr}, *name{nullptr};
+        uint64_t start{0}, end{0};
+    };
+    struct Ring
+    {
+        std::array<Span, ringSize> spans;
+        std::atomic<uint64_t> written{0};
+    };
+
+    static std::atomic<bool> recording;
+    static std::atomic<Ring *> pool;
+    static std::atomic<size_t> claimed;
+    static std::atomic<uint64_t> startedAt;
+};
+
+struct TraceScope
+{
+    TraceScope(const char *c, const char *n) : cat(c), name(n)
+    {
+        if (TraceRecorder::isRecording())
+            start = TraceRecorder::now();
+    }
+    ~TraceScope()
+    {
+        if (start)
+            TraceRecorder::record(cat, name, start, TraceRecorder::now());
+    }
+
+    const char *cat, *name;
+    uint64_t start{0};
+};
+} // namespace baconpaul::twofilters
+
+#define TF_TRACE_CONCAT_IMPL(a, b) a##b
+#define TF_TRACE_CONCAT(a, b) TF_TRACE_CONCAT_IMPL(a, b)
+#define TF_TRACE_SCOPE(cat, name)                                                                  \
+    ::baconpaul::twofilters::TraceScope TF_TRACE_CONCAT(tfTraceScope, __LINE__)(cat, name)
+
+#endif // BACONPAUL_TWOFILTERS_ENGINE_TRACE_RECORDER_H
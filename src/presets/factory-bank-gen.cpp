@@ -0,0 +1,178 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+/*
+ * Build-time tool: compiles resources/factory_patches into factory-bank.cpp. See
+ * presets/factory-bank.h for the table layout.
+ *
+ * Usage: two-filters-bankgen <factory_patches dir> <output .cpp>
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "filesystem/import.h"
+#include "sst/plugininfra/strnatcmp.h"
+
+#include "engine/patch.h"
+
+using namespace baconpaul::twofilters;
+
+namespace
+{
+std::string quoted(const std::string &s)
+{
+    std::string res = "\"";
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\')
+            res += '\\';
+        res += c;
+    }
+    return res + "\"";
+}
+
+// Hex floats round trip exactly, which is the point of pre-parsing.
+std::string floatLiteral(float f)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%af", f);
+    return buf;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <factory_patches dir> <output.cpp>" << std::endl;
+        return 1;
+    }
+
+    auto srcDir = fs::path(argv[1]);
+    auto outFile = fs::path(argv[2]);
+
+    std::map<std::string, std::vector<std::string>> names;
+    try
+    {
+        for (const auto &d : fs::directory_iterator(srcDir))
+        {
+            if (!d.is_directory())
+                continue;
+
+            std::vector<std::string> ents;
+            for (const auto &p : fs::directory_iterator(d.path()))
+            {
+                if (p.is_regular_file() && p.path().extension() == PATCH_EXTENSION)
+                    ents.push_back(p.path().filename().u8string());
+            }
+            std::sort(ents.begin(), ents.end(), [](const auto &a, const auto &b)
+                      { return strnatcasecmp(a.c_str(), b.c_str()) < 0; });
+            names[d.path().filename().u8string()] = ents;
+        }
+    }
+    catch (fs::filesystem_error &e)
+    {
+        std::cerr << "Unable to scan " << srcDir.u8string() << ": " << e.what() << std::endl;
+        return 2;
+    }
+
+    Patch reference;
+
+    std::ostringstream oss;
+    oss << "// Generated by two-filters-bankgen from resources/factory_patches. Do not edit.\n\n"
+        << "#include \"presets/factory-bank.h\"\n\n"
+        << "namespace baconpaul::twofilters::presets::factory_bank\n{\n";
+
+    oss << "const size_t paramCount{" << reference.params.size() << "};\n";
+    oss << "constexpr uint32_t paramIds[] = {";
+    for (const auto *p : reference.params)
+        oss << p->meta.id << ", ";
+    oss << "};\n\n";
+
+    std::ostringstream entries;
+    size_t idx{0};
+    for (const auto &[cat, ents] : names)
+    {
+        for (const auto &fn : ents)
+        {
+            std::ifstream t(srcDir / cat / fn);
+            if (!t.is_open())
+            {
+                std::cerr << "Unable to open " << cat << "/" << fn << std::endl;
+                return 3;
+            }
+            std::stringstream buffer;
+            buffer << t.rdbuf();
+
+            Patch patch;
+            if (!patch.fromState(buffer.str()))
+            {
+                std::cerr << "Unable to parse " << cat << "/" << fn << std::endl;
+                return 1;
+            }
+
+            oss << "// " << cat << "/" << fn << "\n";
+            oss << "constexpr float values" << idx << "[] = {";
+            for (const auto *p : patch.params)
+                oss << floatLiteral(p->value) << ", ";
+            oss << "};\n";
+
+            entries << "    {" << quoted(cat) << ", " << quoted(fn) << ", values" << idx
+                    << ", {";
+            for (const auto &nd : patch.filterNodes)
+            {
+                entries << "{" << (int)nd.model << ", " << (int)nd.config.pt << ", "
+                        << (int)nd.config.st << ", " << (int)nd.config.dt << ", "
+                        << (int)nd.config.mt << "}, ";
+            }
+            entries << "}},\n";
+            idx++;
+        }
+    }
+
+    oss << "\nconst size_t entryCount{" << idx << "};\n";
+    if (idx == 0)
+        entries << "    {},\n";
+    oss << "constexpr Entry entries[] = {\n" << entries.str() << "};\n";
+    oss << "} // namespace baconpaul::twofilters::presets::factory_bank\n";
+
+    // Leave an unchanged output alone so the plugin doesn't relink on every bankgen rebuild.
+    auto res = oss.str();
+    {
+        std::ifstream existing(outFile);
+        if (existing.is_open())
+        {
+            std::stringstream eb;
+            eb << existing.rdbuf();
+            if (eb.str() == res)
+                return 0;
+        }
+    }
+
+    std::ofstream ofs(outFile);
+    if (!ofs.is_open())
+    {
+        std::cerr << "Unable to write " << outFile.u8string() << std::endl;
+        return 4;
+    }
+    ofs << res;
+    return 0;
+}
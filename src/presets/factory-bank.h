@@ -0,0 +1,55 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_PRESETS_FACTORY_BANK_H
+#define BACONPAUL_TWOFILTERS_PRESETS_FACTORY_BANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include "configuration.h"
+
+/*
+ * The factory patches, pre-parsed at build time. twofilters-bankgen loads every
+ * resources/factory_patches/<category>/<name>.twofl through Patch::fromState (so migrations
+ * have already run) and writes factory-bank.cpp with the resulting values. Loading a factory
+ * preset is then a copy of one row of floats and the filter setups, with no XML involved.
+ *
+ * Values are stored in Patch::params order; paramIds records that order so a mismatch
+ * (which can only happen if the generator and the plugin were built from different sources)
+ * is detectable.
+ */
+namespace baconpaul::twofilters::presets::factory_bank
+{
+struct FilterSetup
+{
+    int32_t model, pt, st, dt, mt;
+};
+
+struct Entry
+{
+    const char *category;
+    const char *fileName; // including PATCH_EXTENSION, as the menus have always used
+    const float *values;
+    FilterSetup filters[numFilters];
+};
+
+// Entries are ordered by category, then natural-case filename, which is menu order.
+extern const size_t entryCount;
+extern const Entry entries[];
+
+extern const size_t paramCount;
+extern const uint32_t paramIds[];
+} // namespace baconpaul::twofilters::presets::factory_bank
+#endif // BACONPAUL_TWOFILTERS_PRESETS_FACTORY_BANK_H
@@ -17,13 +17,13 @@
 #include <sstream>
 #include <fstream>
 #include <cstring>
+#include <algorithm>
 #include "sst/plugininfra/paths.h"
 
 #include "sst/plugininfra/strnatcmp.h"
+#include "engine/trace-recorder.h"
 
-#include <cmrc/cmrc.hpp>
-
-CMRC_DECLARE(twofilters_patches);
+#include "factory-bank.h"
 
 namespace baconpaul::twofilters::presets
 {
@@ -58,41 +58,26 @@ PresetManager::PresetManager(const clap_host_t *ch) : clapHost(ch)
         SQLOG("Unable to create user dir " << e.what());
     }
 
-    try
+    // The bank is already in menu order, so this is just an index build; no resource scan.
+    factoryPatchVector.reserve(factory_bank::entryCount);
+    for (size_t i = 0; i < factory_bank::entryCount; ++i)
     {
-        auto fs = cmrc::twofilters_patches::get_filesystem();
-        for (const auto &d : fs.iterate_directory(factoryPath))
-        {
-            if (d.is_directory())
-            {
-                std::vector<std::string> ents;
-                for (const auto &p :
-                     fs.iterate_directory(std::string() + factoryPath + "/" + d.filename()))
-                {
-                    ents.push_back(p.filename());
-                }
+        const auto &e = factory_bank::entries[i];
+        factoryPatchNames[e.category].emplace_back(e.fileName);
+        factoryPatchVector.emplace_back(e.category, e.fileName);
+    }
 
-                std::sort(ents.begin(), ents.end(), [](const auto &a, const auto &b)
-                          { return strnatcasecmp(a.c_str(), b.c_str()) < 0; });
-                factoryPatchNames[d.filename()] = ents;
-            }
-        }
+    rescanUserPresets();
 
-        factoryPatchVector.clear();
-        for (const auto &[c, st] : factoryPatchNames)
-        {
-            for (const auto &pn : st)
-            {
-                factoryPatchVector.emplace_back(c, pn);
-            }
-        }
-    }
-    catch (const std::exception &e)
+    // Only a writable (hosted) manager watches; the read-only ones are short lived.
+    if (clapHost)
     {
-        SQLOG(e.what());
-    }
+        userPatchWatcher = std::make_unique<UserPatchWatcher>(userPatchesPath);
+        if (!userPatchWatcher->isActive())
+            userPatchWatcher.reset();
 
-    rescanUserPresets();
+        prefetcher = std::make_unique<PresetPrefetcher>();
+    }
 }
 
 PresetManager::~PresetManager() = default;
@@ -127,36 +112,106 @@ void PresetManager::rescanUserPresets()
             }
         };
         itd(userPatchesPath);
-        std::sort(userPatches.begin(), userPatches.end(),
-                  [](const fs::path &a, const fs::path &b)
-                  {
-                      auto appe = a.parent_path().empty();
-                      auto bppe = b.parent_path().empty();
-
-                      if (appe && bppe)
-                      {
-                          return strnatcasecmp(a.filename().u8string().c_str(),
-                                               b.filename().u8string().c_str()) < 0;
-                      }
-                      else if (appe)
-                      {
-                          return true;
-                      }
-                      else if (bppe)
-                      {
-                          return false;
-                      }
-                      else
-                      {
-                          return a < b;
-                      }
-                  });
+        std::sort(userPatches.begin(), userPatches.end(), userPatchOrder);
     }
     catch (fs::filesystem_error &)
     {
     }
 }
 
+bool PresetManager::userPatchOrder(const fs::path &a, const fs::path &b)
+{
+    auto appe = a.parent_path().empty();
+    auto bppe = b.parent_path().empty();
+
+    if (appe && bppe)
+    {
+        return strnatcasecmp(a.filename().u8string().c_str(), b.filename().u8string().c_str()) <
+               0;
+    }
+    else if (appe)
+    {
+        return true;
+    }
+    else if (bppe)
+    {
+        return false;
+    }
+    else
+    {
+        return a < b;
+    }
+}
+
+void PresetManager::addUserPatch(const fs::path &rel)
+{
+    if (rel.extension() != PATCH_EXTENSION)
+        return;
+    auto it = std::lower_bound(userPatches.begin(), userPatches.end(), rel, userPatchOrder);
+    if (it != userPatches.end() && *it == rel)
+        return;
+    userPatches.insert(it, rel);
+}
+
+void PresetManager::addUserPatchesUnder(const fs::path &rel)
+{
+    // A directory arriving (mkdir, or a whole folder synced or moved in) is the one case
+    // where we have to look at disk, and then only at that subtree.
+    try
+    {
+        for (auto &el : fs::recursive_directory_iterator(userPatchesPath / rel))
+        {
+            if (el.is_regular_file())
+                addUserPatch(el.path().lexically_relative(userPatchesPath));
+        }
+    }
+    catch (fs::filesystem_error &)
+    {
+    }
+}
+
+void PresetManager::removeUserPatchesUnder(const fs::path &rel)
+{
+    auto under = [&rel](const fs::path &p)
+    {
+        auto [rEnd, pEnd] = std::mismatch(rel.begin(), rel.end(), p.begin(), p.end());
+        return rEnd == rel.end();
+    };
+    userPatches.erase(std::remove_if(userPatches.begin(), userPatches.end(), under),
+                      userPatches.end());
+}
+
+bool PresetManager::processUserPatchChanges()
+{
+    if (!userPatchWatcher)
+        return false;
+
+    auto deltas = userPatchWatcher->readDeltas();
+    if (deltas.empty())
+        return false;
+
+    for (const auto &d : deltas)
+    {
+        switch (d.kind)
+        {
+        case UserPatchWatcher::Delta::FILE_ADDED:
+            addUserPatch(d.relPath);
+            break;
+        case UserPatchWatcher::Delta::FILE_REMOVED:
+        case UserPatchWatcher::Delta::DIR_REMOVED:
+            removeUserPatchesUnder(d.relPath);
+            break;
+        case UserPatchWatcher::Delta::DIR_ADDED:
+            addUserPatchesUnder(d.relPath);
+            break;
+        case UserPatchWatcher::Delta::QUEUE_OVERFLOW:
+            rescanUserPresets();
+            return true;
+        }
+    }
+    return true;
+}
+
 #if USE_WCHAR_PRESET
 void PresetManager::saveUserPresetDirect(Patch &patch, const wchar_t *fname)
 {
@@ -167,7 +222,10 @@ void PresetManager::saveUserPresetDirect(Patch &patch, const wchar_t *fname)
         ofs << patch.toState();
     }
     ofs.close();
-    rescanUserPresets();
+    if (userPatchWatcher)
+        processUserPatchChanges();
+    else
+        rescanUserPresets();
 }
 #else
 void PresetManager::saveUserPresetDirect(Patch &patch, const fs::path &pt)
@@ -179,76 +237,134 @@ void PresetManager::saveUserPresetDirect(Patch &patch, const fs::path &pt)
         ofs << patch.toState();
     }
     ofs.close();
-    rescanUserPresets();
+    if (userPatchWatcher)
+        processUserPatchChanges();
+    else
+        rescanUserPresets();
 }
 #endif
 
 void PresetManager::loadUserPresetDirect(Patch &patch, Engine::mainToAudioQueue_T &mainToAudio,
                                          const fs::path &p)
 {
-    std::ifstream t(p);
-    if (!t.is_open())
-        return;
-    std::stringstream buffer;
-    buffer << t.rdbuf();
+    TF_TRACE_SCOPE("main", "PresetManager::loadUserPresetDirect");
+    if (!prefetcher || !prefetcher->tryApply(p, patch))
+    {
+        std::ifstream t(p);
+        if (!t.is_open())
+            return;
+        std::stringstream buffer;
+        buffer << t.rdbuf();
 
-    patch.fromState(buffer.str());
+        // As the prefetcher does: nothing the file leaves out may carry over from the last one
+        patch.resetToInit();
+        patch.fromState(buffer.str());
+    }
 
     auto dn = p.filename().replace_extension("").u8string();
     nameAndMarkClean(patch, dn);
-    Engine::sendEntirePatchToAudio(patch, mainToAudio, clapHost);
+    Engine::sendEntirePatchToAudio(patch, mainToAudio, clapHost, nullptr, transitionMs);
     if (onPresetLoaded)
         onPresetLoaded(dn);
+
+    if (prefetcher)
+    {
+        auto rel = p.lexically_relative(userPatchesPath);
+        auto it = std::lower_bound(userPatches.begin(), userPatches.end(), rel, userPatchOrder);
+        if (it != userPatches.end() && *it == rel)
+            prefetchAround(factoryPatchVector.size() + (it - userPatches.begin()));
+    }
+}
+
+void PresetManager::prefetchAround(size_t flatIndex)
+{
+    if (!prefetcher)
+        return;
+
+    std::vector<fs::path> paths;
+    auto add = [&](int64_t flat)
+    {
+        auto u = flat - (int64_t)factoryPatchVector.size();
+        if (u >= 0 && u < (int64_t)userPatches.size())
+            paths.push_back(userPatchesPath / userPatches[u]);
+    };
+    for (int d = 1; d <= prefetchRadius; ++d)
+    {
+        add((int64_t)flatIndex + d);
+        add((int64_t)flatIndex - d);
+    }
+    prefetcher->request(std::move(paths));
 }
 
 void PresetManager::loadFactoryPreset(Patch &patch, Engine::mainToAudioQueue_T &mainToAudio,
                                       const std::string &cat, const std::string &pat)
 {
-    try
+    // can we find this factory preset
+    size_t idx{0};
+    for (idx = 0; idx < factoryPatchVector.size(); idx++)
     {
-        auto fs = cmrc::twofilters_patches::get_filesystem();
-        auto f = fs.open(std::string() + factoryPath + "/" + cat + "/" + pat);
-        auto pb = std::string(f.begin(), f.end());
-        patch.fromState(pb);
-
-        // can we find this factory preset
-        int idx{0};
-        for (idx = 0; idx < factoryPatchVector.size(); idx++)
-        {
-            if (factoryPatchVector[idx].first == cat && factoryPatchVector[idx].second == pat)
-                break;
-        }
+        if (factoryPatchVector[idx].first == cat && factoryPatchVector[idx].second == pat)
+            break;
+    }
 
-        if (idx == factoryPatchVector.size())
-        {
-            return;
-        }
+    if (idx == factoryPatchVector.size())
+    {
+        return;
+    }
+    loadFactoryPreset(patch, mainToAudio, idx);
+}
 
-        auto noExt = pat;
-        auto ps = noExt.find(PATCH_EXTENSION);
-        if (ps != std::string::npos)
-        {
-            noExt = noExt.substr(0, ps);
-        }
-        nameAndMarkClean(patch, noExt);
-        Engine::sendEntirePatchToAudio(patch, mainToAudio, clapHost);
+void PresetManager::loadFactoryPreset(Patch &patch, Engine::mainToAudioQueue_T &mainToAudio,
+                                      size_t idx)
+{
+    TF_TRACE_SCOPE("main", "PresetManager::loadFactoryPreset");
+    if (idx >= factory_bank::entryCount)
+        return;
 
-        if (onPresetLoaded)
-        {
-            onPresetLoaded(noExt);
-        }
+    if (factory_bank::paramCount != patch.params.size())
+    {
+        SQLOG_ERR("Factory bank was generated for a different patch layout");
+        return;
     }
-    catch (const std::exception &e)
+
+    const auto &e = factory_bank::entries[idx];
+    for (size_t i = 0; i < factory_bank::paramCount; ++i)
+        patch.params[i]->value = e.values[i];
+    for (size_t i = 0; i < numFilters; ++i)
     {
-        SQLOG(e.what());
+        auto &nd = patch.filterNodes[i];
+        const auto &fs = e.filters[i];
+        nd.model = (sst::filtersplusplus::FilterModel)fs.model;
+        nd.config.pt = (sst::filtersplusplus::Passband)fs.pt;
+        nd.config.st = (sst::filtersplusplus::Slope)fs.st;
+        nd.config.dt = (sst::filtersplusplus::DriveMode)fs.dt;
+        nd.config.mt = (sst::filtersplusplus::FilterSubModel)fs.mt;
     }
+
+    auto noExt = std::string(e.fileName);
+    auto ps = noExt.find(PATCH_EXTENSION);
+    if (ps != std::string::npos)
+    {
+        noExt = noExt.substr(0, ps);
+    }
+    nameAndMarkClean(patch, noExt);
+    Engine::sendEntirePatchToAudio(patch, mainToAudio, clapHost, nullptr, transitionMs);
+
+    if (onPresetLoaded)
+    {
+        onPresetLoaded(noExt);
+    }
+
+    // Near the end of the factory list the next steps are the first user presets.
+    prefetchAround(idx);
 }
 
 void PresetManager::loadInit(Patch &patch, Engine::mainToAudioQueue_T &mainToAudio)
 {
+    TF_TRACE_SCOPE("main", "PresetManager::loadInit");
     patch.resetToInit();
     nameAndMarkClean(patch, "Init");
-    Engine::sendEntirePatchToAudio(patch, mainToAudio, clapHost);
+    Engine::sendEntirePatchToAudio(patch, mainToAudio, clapHost, nullptr, transitionMs);
     if (onPresetLoaded)
         onPresetLoaded("Init");
 }
@@ -21,7 +21,10 @@
 #include "sst/jucegui/data/Discrete.h"
 #include "engine/patch.h"
 #include "engine/engine.h"
+#include "presets/user-patch-watcher.h"
+#include "presets/preset-prefetcher.h"
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <functional>
 #include <set>
@@ -41,10 +44,27 @@ struct PresetManager
 
     void rescanUserPresets();
 
+    // Incremental maintenance of userPatches from the watcher. Call on the main thread when
+    // the watcher fd is readable. Returns true if userPatches changed.
+    bool processUserPatchChanges();
+    std::unique_ptr<UserPatchWatcher> userPatchWatcher;
+
+    // Keep the user presets within prefetchRadius of flatIndex (factory then user order, as
+    // the preset browser steps through them) parsed in the background.
+#if TWOFILTERS_LOW_FOOTPRINT
+    static constexpr int prefetchRadius{1};
+#else
+    static constexpr int prefetchRadius{4};
+#endif
+    void prefetchAround(size_t flatIndex);
+    std::unique_ptr<PresetPrefetcher> prefetcher;
+
     void loadInit(Patch &p, Engine::mainToAudioQueue_T &);
     void loadUserPresetDirect(Patch &, Engine::mainToAudioQueue_T &, const fs::path &p);
     void loadFactoryPreset(Patch &, Engine::mainToAudioQueue_T &, const std::string &cat,
                            const std::string &pat);
+    // idx is into factoryPatchVector, which matches the factory bank order
+    void loadFactoryPreset(Patch &, Engine::mainToAudioQueue_T &, size_t idx);
 
 #if USE_WCHAR_PRESET
     void saveUserPresetDirect(Patch &, const wchar_t *utf8path);
@@ -54,10 +74,18 @@ struct PresetManager
 
     std::function<void(const std::string &)> onPresetLoaded{nullptr};
 
-    static constexpr const char *factoryPath{"resources/factory_patches"};
+    // Crossfade length for loads, in milliseconds; 0 stops audio and resets as before.
+    int32_t transitionMs{0};
+
     std::map<std::string, std::vector<std::string>> factoryPatchNames;
     std::vector<std::pair<std::string, std::string>> factoryPatchVector;
     std::vector<fs::path> userPatches;
+
+  private:
+    static bool userPatchOrder(const fs::path &a, const fs::path &b);
+    void addUserPatch(const fs::path &rel);
+    void addUserPatchesUnder(const fs::path &rel);
+    void removeUserPatchesUnder(const fs::path &rel);
 };
 } // namespace baconpaul::twofilters::presets
 #endif // PRESET_MANAGER_H
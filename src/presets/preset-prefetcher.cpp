@@ -0,0 +1,174 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "preset-prefetcher.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace baconpaul::twofilters::presets
+{
+PresetPrefetcher::PresetPrefetcher()
+{
+    thread = std::make_unique<std::thread>([this]() { run(); });
+}
+
+PresetPrefetcher::~PresetPrefetcher()
+{
+    running = false;
+    {
+        std::unique_lock<std::mutex> l(requestM);
+        requestCV.notify_one();
+    }
+    thread->join();
+}
+
+void PresetPrefetcher::request(std::vector<fs::path> paths)
+{
+    std::unique_lock<std::mutex> l(requestM);
+    wanted = std::move(paths);
+    requestCount++;
+    requestCV.notify_one();
+}
+
+bool PresetPrefetcher::tryApply(const fs::path &path, Patch &patch)
+{
+    fs::file_time_type mtime;
+    try
+    {
+        mtime = fs::last_write_time(path);
+    }
+    catch (fs::filesystem_error &)
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> l(cacheM);
+    auto it = cache.find(path);
+    if (it == cache.end() || it->second.mtime != mtime ||
+        it->second.values.size() != patch.params.size())
+        return false;
+
+    const auto &pr = it->second;
+    for (size_t i = 0; i < pr.values.size(); ++i)
+        patch.params[i]->value = pr.values[i];
+    for (size_t i = 0; i < numFilters; ++i)
+    {
+        patch.filterNodes[i].model = pr.models[i];
+        patch.filterNodes[i].config = pr.configs[i];
+    }
+    return true;
+}
+
+bool PresetPrefetcher::prepare(const fs::path &p, Prepared &into)
+{
+    try
+    {
+        into.mtime = fs::last_write_time(p);
+    }
+    catch (fs::filesystem_error &)
+    {
+        return false;
+    }
+
+    std::ifstream t(p);
+    if (!t.is_open())
+        return false;
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+
+    // workPatch is reused, so nothing the file leaves out may carry over from the last one
+    workPatch.resetToInit();
+    if (!workPatch.fromState(buffer.str()))
+        return false;
+
+    into.values.resize(workPatch.params.size());
+    for (size_t i = 0; i < workPatch.params.size(); ++i)
+        into.values[i] = workPatch.params[i]->value;
+    for (size_t i = 0; i < numFilters; ++i)
+    {
+        into.models[i] = workPatch.filterNodes[i].model;
+        into.configs[i] = workPatch.filterNodes[i].config;
+    }
+    return true;
+}
+
+void PresetPrefetcher::run()
+{
+    int lastRequest{0};
+    while (running)
+    {
+        std::vector<fs::path> todo;
+        {
+            std::unique_lock<std::mutex> l(requestM);
+            if (lastRequest == requestCount)
+                requestCV.wait(l);
+            if (!running)
+                break;
+            lastRequest = requestCount;
+            todo = wanted;
+        }
+
+        {
+            std::unique_lock<std::mutex> l(cacheM);
+            for (auto it = cache.begin(); it != cache.end();)
+            {
+                if (std::find(todo.begin(), todo.end(), it->first) == todo.end())
+                    it = cache.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        // todo is nearest-first, so a fast stepper gets the neighbours before the far edge
+        for (const auto &p : todo)
+        {
+            if (!running)
+                break;
+
+            {
+                std::unique_lock<std::mutex> l(requestM);
+                if (requestCount != lastRequest)
+                    break;
+            }
+
+            bool fresh{false};
+            {
+                std::unique_lock<std::mutex> l(cacheM);
+                auto it = cache.find(p);
+                if (it != cache.end())
+                {
+                    try
+                    {
+                        fresh = it->second.mtime == fs::last_write_time(p);
+                    }
+                    catch (fs::filesystem_error &)
+                    {
+                    }
+                }
+            }
+            if (fresh)
+                continue;
+
+            Prepared pr;
+            if (prepare(p, pr))
+            {
+                std::unique_lock<std::mutex> l(cacheM);
+                cache[p] = std::move(pr);
+            }
+        }
+    }
+}
+} // namespace baconpaul::twofilters::presets
@@ -0,0 +1,76 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_PRESETS_PRESET_PREFETCHER_H
+#define BACONPAUL_TWOFILTERS_PRESETS_PRESET_PREFETCHER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <map>
+#include <memory>
+#include "filesystem/import.h"
+#include "engine/patch.h"
+
+namespace baconpaul::twofilters::presets
+{
+/*
+ * Keeps a window of user presets read and parsed on a worker thread, so stepping to the
+ * next or previous one only has to copy values into the patch. The worker parses into its
+ * own Patch and keeps the results as value rows in Patch::params order, keyed by path and
+ * checked against the file's modification time so an edited file is never served stale.
+ *
+ * Factory presets don't need this; they are pre-parsed at build time.
+ */
+struct PresetPrefetcher
+{
+    PresetPrefetcher();
+    ~PresetPrefetcher();
+
+    // Replace the wanted set. Entries outside it are dropped once the worker catches up.
+    void request(std::vector<fs::path> paths);
+
+    // Copy a prefetched preset into patch. False means not (or no longer) cached, and the
+    // caller should load from disk as usual.
+    bool tryApply(const fs::path &path, Patch &patch);
+
+  private:
+    struct Prepared
+    {
+        fs::file_time_type mtime;
+        std::vector<float> values;
+        sst::filtersplusplus::FilterModel models[numFilters];
+        sst::filtersplusplus::ModelConfig configs[numFilters];
+    };
+
+    void run();
+    bool prepare(const fs::path &p, Prepared &into);
+
+    std::unique_ptr<std::thread> thread;
+    std::mutex requestM, cacheM;
+    std::condition_variable requestCV;
+    std::atomic<bool> running{true};
+
+    std::vector<fs::path> wanted; // guarded by requestM
+    int requestCount{0};          // guarded by requestM
+
+    std::map<fs::path, Prepared> cache; // guarded by cacheM
+
+    Patch workPatch; // worker thread only
+};
+} // namespace baconpaul::twofilters::presets
+#endif // BACONPAUL_TWOFILTERS_PRESETS_PRESET_PREFETCHER_H
@@ -0,0 +1,180 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "user-patch-watcher.h"
+#include "configuration.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#endif
+
+namespace baconpaul::twofilters::presets
+{
+#if defined(__linux__)
+
+namespace
+{
+bool isSameOrUnder(const fs::path &p, const fs::path &dir)
+{
+    auto [dEnd, pEnd] = std::mismatch(dir.begin(), dir.end(), p.begin(), p.end());
+    return dEnd == dir.end();
+}
+} // namespace
+
+static constexpr uint32_t watchMask{IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                    IN_MOVED_TO | IN_ONLYDIR};
+
+UserPatchWatcher::UserPatchWatcher(const fs::path &r) : root(r)
+{
+    try
+    {
+        if (!fs::is_directory(root))
+            return;
+    }
+    catch (fs::filesystem_error &)
+    {
+        return;
+    }
+
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        SQLOG("Unable to start user patch watcher; errno=" << errno);
+        return;
+    }
+    watchTree(fs::path());
+}
+
+UserPatchWatcher::~UserPatchWatcher()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+void UserPatchWatcher::watchTree(const fs::path &rel)
+{
+    auto full = rel.empty() ? root : root / rel;
+    auto wd = inotify_add_watch(fd, full.u8string().c_str(), watchMask);
+    if (wd < 0)
+        return;
+    dirByWatch[wd] = rel;
+
+    try
+    {
+        for (auto &el : fs::directory_iterator(full))
+        {
+            if (el.is_directory())
+                watchTree(rel / el.path().filename());
+        }
+    }
+    catch (fs::filesystem_error &)
+    {
+    }
+}
+
+void UserPatchWatcher::unwatchTree(const fs::path &rel)
+{
+    for (auto it = dirByWatch.begin(); it != dirByWatch.end();)
+    {
+        if (isSameOrUnder(it->second, rel))
+        {
+            // A moved-away directory keeps its watch alive (and would keep reporting under
+            // its old name) so remove it explicitly. Deleted ones are already gone.
+            inotify_rm_watch(fd, it->first);
+            it = dirByWatch.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+std::vector<UserPatchWatcher::Delta> UserPatchWatcher::readDeltas()
+{
+    std::vector<Delta> res;
+    if (fd < 0)
+        return res;
+
+    alignas(inotify_event) char buf[16384];
+    while (true)
+    {
+        auto len = read(fd, buf, sizeof(buf));
+        if (len <= 0)
+            break;
+
+        for (char *ptr = buf; ptr < buf + len;)
+        {
+            auto *ev = reinterpret_cast<const inotify_event *>(ptr);
+            ptr += sizeof(inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW)
+            {
+                res.push_back({Delta::QUEUE_OVERFLOW, {}});
+                continue;
+            }
+            if (ev->mask & IN_IGNORED)
+            {
+                dirByWatch.erase(ev->wd);
+                continue;
+            }
+
+            auto dit = dirByWatch.find(ev->wd);
+            if (dit == dirByWatch.end() || ev->len == 0)
+                continue;
+
+            auto rel = dit->second / fs::path(std::string(ev->name));
+
+            if (ev->mask & IN_ISDIR)
+            {
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    watchTree(rel);
+                    res.push_back({Delta::DIR_ADDED, rel});
+                }
+                else if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+                {
+                    unwatchTree(rel);
+                    res.push_back({Delta::DIR_REMOVED, rel});
+                }
+            }
+            else
+            {
+                // Files report on close-after-write rather than create, so a half written
+                // save never shows up in the menu.
+                if (ev->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                    res.push_back({Delta::FILE_ADDED, rel});
+                else if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+                    res.push_back({Delta::FILE_REMOVED, rel});
+            }
+        }
+    }
+    return res;
+}
+
+#else
+
+UserPatchWatcher::UserPatchWatcher(const fs::path &r) : root(r) {}
+UserPatchWatcher::~UserPatchWatcher() = default;
+void UserPatchWatcher::watchTree(const fs::path &) {}
+void UserPatchWatcher::unwatchTree(const fs::path &) {}
+std::vector<UserPatchWatcher::Delta> UserPatchWatcher::readDeltas() { return {}; }
+
+#endif
+
+} // namespace baconpaul::twofilters::presets
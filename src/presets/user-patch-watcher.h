@@ -0,0 +1,65 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_PRESETS_USER_PATCH_WATCHER_H
+#define BACONPAUL_TWOFILTERS_PRESETS_USER_PATCH_WATCHER_H
+
+#include <vector>
+#include <unordered_map>
+#include "filesystem/import.h"
+
+namespace baconpaul::twofilters::presets
+{
+/*
+ * Watches the user Patches folder and reports what changed, relative to the root, rather
+ * than making the preset manager re-walk the tree. On linux this is an inotify instance
+ * with one watch per directory; fileDescriptor() is readable whenever there are pending
+ * changes, so it can be handed to the host's posix-fd support and drained on the main
+ * thread. On other platforms the watcher is inactive and callers keep rescanning.
+ */
+struct UserPatchWatcher
+{
+    struct Delta
+    {
+        enum Kind
+        {
+            FILE_ADDED,
+            FILE_REMOVED,
+            DIR_ADDED,
+            DIR_REMOVED,
+            QUEUE_OVERFLOW // the kernel dropped events; only a full rescan is safe
+        } kind;
+        fs::path relPath;
+    };
+
+    explicit UserPatchWatcher(const fs::path &root);
+    ~UserPatchWatcher();
+
+    bool isActive() const { return fd >= 0; }
+    int fileDescriptor() const { return fd; }
+
+    // Non-blocking. Returns every delta queued since the last call (possibly none).
+    std::vector<Delta> readDeltas();
+
+  private:
+    void watchTree(const fs::path &rel);
+    void unwatchTree(const fs::path &rel);
+
+    fs::path root;
+    int fd{-1};
+    std::unordered_map<int, fs::path> dirByWatch;
+};
+} // namespace baconpaul::twofilters::presets
+#endif // BACONPAUL_TWOFILTERS_PRESETS_USER_PATCH_WATCHER_H
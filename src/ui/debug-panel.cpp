@@ -16,6 +16,7 @@
 #include "debug-panel.h"
 #include "plugin-editor.h"
 #include "patch-data-bindings.h"
+#include "sst/jucegui/components/BaseStyles.h"
 
 namespace baconpaul::twofilters::ui
 {
@@ -34,6 +35,27 @@ DebugPanel::DebugPanel(PluginEditor &e)
         createComponent(editor, *this, *editor.patchMainRef.params[i], knobs[i], knobAs[i]);
         addAndMakeVisible(*knobs[i]);
     }
+
+    if (editor.describeMemory)
+        memoryText = editor.describeMemory();
+}
+
+void DebugPanel::paint(juce::Graphics &g)
+{
+    sst::jucegui::components::NamedPanel::paint(g);
+    namespace bst = sst::jucegui::components::base_styles;
+    g.setColour(style()->getColour(bst::BaseLabel::styleClass, bst::BaseLabel::labelcolor));
+    g.setFont(style()->getFont(bst::BaseLabel::styleClass, bst::BaseLabel::labelfont));
+    auto b = getContentArea();
+    auto txt = memoryText;
+#if TWOFILTERS_DSP_TIMING
+    const auto &st = editor.dspTimingStats;
+    for (int k = 0; k < 2; ++k)
+        txt += fmt::format("\n{} p50/p99/worst: {:.0f}/{:.0f}/{:.0f} {}",
+                           k == 0 ? "Control" : "Audio", st[2 * k][0], st[2 * k][1],
+                           st[2 * k + 1][0], DspTiming::unitName);
+#endif
+    g.drawMultiLineText(txt, b.getRight() - 300, b.getY() + 12, 295);
 }
 
 void DebugPanel::resized()
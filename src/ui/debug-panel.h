@@ -26,11 +26,13 @@ struct DebugPanel : sst::jucegui::components::NamedPanel
 {
     DebugPanel(PluginEditor &editor);
     void resized() override;
+    void paint(juce::Graphics &g) override;
 
     std::vector<std::unique_ptr<sst::jucegui::components::Knob>> knobs;
     std::vector<std::unique_ptr<PatchContinuous>> knobAs;
 
     PluginEditor &editor;
+    std::string memoryText;
 
     void beginEdit() {}
     void endEdit(int id) {}
@@ -16,10 +16,12 @@
 #include "filter-panel.h"
 
 #include "steplfo-panel.h"
+#include "filter-plot-service.h"
+#include "engine/trace-recorder.h"
 
 #include <map>
+#include <chrono>
 
-#include "sst/filters/FilterPlotter.h"
 #include "sst/jucegui/components/BaseStyles.h"
 #include "sst/jucegui/component-adapters/ComponentTags.h"
 
@@ -28,116 +30,15 @@ namespace baconpaul::twofilters::ui
 
 struct FilterCurve : juce::Component
 {
-    // put the thread here waiting and have rebuild trigger it and onilde poll it
-    std::unique_ptr<std::thread> thread;
-    std::mutex sendM, dataM;
-    std::condition_variable sendCV;
-    std::atomic<bool> running{true};
-    int updateRequest{0};
-    int repaintReq{0}, lastRepaintReq{0};
-    FilterCurve(FilterPanel &p) : panel(p)
-    {
-        thread = std::make_unique<std::thread>([this]() { run(); });
-    }
-    ~FilterCurve()
-    {
-        running = false;
-        {
-            std::unique_lock<std::mutex> l(sendM);
-            sendCV.notify_one();
-        }
-        thread->join();
-    }
+    // Declared in this order so the client goes before the service it points at. The client
+    // itself may linger in the service queue after we are gone; it just publishes to nobody.
+    std::shared_ptr<FilterPlotService> plotService;
+    std::shared_ptr<FilterPlotService::Client> plotClient;
 
-    void run()
+    FilterCurve(FilterPanel &p) : panel(p)
     {
-        int lur{0};
-        auto lastWait = std::chrono::high_resolution_clock::now();
-
-        while (running)
-        {
-            int nur{lur};
-            {
-                std::unique_lock<std::mutex> l(sendM);
-                if (nur != updateRequest)
-                {
-                    nur = updateRequest;
-                }
-                else
-                {
-                    sendCV.wait(l);
-                }
-            }
-            auto postLastWait = std::chrono::high_resolution_clock::now();
-            auto dur =
-                std::chrono::duration_cast<std::chrono::microseconds>(postLastWait - lastWait);
-#if JUCE_WINDOWS
-            auto atLeast = 1000000 / 30.0;
-#else
-            auto atLeast = 1000000 / 60.0;
-#endif
-
-            if (dur.count() < atLeast)
-            {
-                std::this_thread::sleep_for(
-                    std::chrono::microseconds((int)(atLeast - dur.count())));
-            }
-            if (running && nur != lur)
-            {
-                float lco, lre, lmo;
-                sst::filtersplusplus::FilterModel lmodel;
-                sst::filtersplusplus::ModelConfig lconfig;
-
-                {
-                    std::unique_lock<std::mutex> l(dataM);
-
-                    nur = updateRequest;
-                    lur = nur;
-
-                    lco = co;
-                    lre = res;
-                    lmo = morph;
-                    lmodel = snapModel;
-                    lconfig = snapConfig;
-                }
-                if (lmodel == sst::filtersplusplus::FilterModel::None)
-                {
-                    {
-                        std::unique_lock<std::mutex> l(dataM);
-                        cX.clear();
-                        cY.clear();
-                        cX.push_back(0.5);
-                        cX.push_back(5.0);
-                        cY.push_back(0.0);
-                        cY.push_back(0.0);
-
-                        repaintReq++;
-                    }
-                }
-                else
-                {
-                    if (sst::filtersplusplus::Filter::coefficientsExtraIsBipolar(lmodel, lconfig,
-                                                                                 0))
-                        lmo = lmo * 2 - 1;
-
-                    auto par = sst::filters::FilterPlotParameters();
-                    par.freqSmoothOctaves = 1.0 / 36.0;
-                    auto crv = plotter.plotFilterMagnitudeResponse(lmodel, lconfig, lco, lre, lmo,
-                                                                   0, 0, par);
-                    auto tcX = crv.first;
-                    for (auto &x : tcX)
-                        x = (x > 0 ? log10(x) : 0);
-
-                    {
-                        std::unique_lock<std::mutex> l(dataM);
-                        cX = tcX;
-                        cY = crv.second;
-                        repaintReq++;
-                    }
-                }
-            }
-            lastWait = std::chrono::high_resolution_clock::now();
-        }
+        plotService = FilterPlotService::instance();
+        plotClient = plotService->makeClient();
     }
 
     bool showDragEdit{false};
@@ -179,6 +80,8 @@ struct FilterCurve : juce::Component
         }
         panel.cutoffK->onBeginEdit();
         panel.resonanceK->onBeginEdit();
+        // a drag is starting, so plot drafts from the first move
+        lastRebuild = std::chrono::steady_clock::now();
         positionToCoRes(event.position.toFloat());
         repaint();
     }
@@ -249,6 +152,7 @@ struct FilterCurve : juce::Component
     juce::Image renderCache;
     void paint(juce::Graphics &gReal) override
     {
+        TF_TRACE_SCOPE("ui", "FilterCurve::paint");
         /*
          * The updated setp sequence causes a repaint here which on some windows boxes is
          * painful so just cache the image
@@ -293,7 +197,8 @@ struct FilterCurve : juce::Component
         juce::Graphics g(renderCache);
         g.fillAll(juce::Colours::black);
         g.addTransform(juce::AffineTransform::scale(sc, sc));
-        std::unique_lock<std::mutex> l(dataM);
+        const auto &cX = plotClient->current().x;
+        const auto &cY = plotClient->current().y;
 
         namespace bst = sst::jucegui::components::base_styles;
         g.fillAll(panel.style()->getColour(bst::ValueGutter::styleClass, bst::ValueGutter::gutter));
@@ -351,9 +256,9 @@ struct FilterCurve : juce::Component
         fillpath.lineTo(tx(cX[0]), ty(my));
         fillpath.closeSubPath();
 
-        if (cX.size() > 10 && panel.editor.cpuGraphicsMode != PluginEditor::MINIMAL)
+        if (cX.size() > 10 && panel.editor.graphicsMode() != PluginEditor::MINIMAL)
         {
-            if (panel.editor.cpuGraphicsMode != PluginEditor::FULL)
+            if (panel.editor.graphicsMode() != PluginEditor::FULL)
             {
                 g.setColour(c.withAlpha(0.2f));
             }
@@ -390,8 +295,8 @@ struct FilterCurve : juce::Component
     void drawCrosshairs(juce::Graphics &gReal)
     {
         auto &fn = panel.editor.patchMainRef.filterNodes[panel.instance];
-        co = fn.cutoff;
-        res = fn.resonance;
+        float co = fn.cutoff;
+        float res = fn.resonance;
 
         auto freq = 440 * pow(2, co / 12.0);
         auto lfre = log10(freq);
@@ -410,50 +315,58 @@ struct FilterCurve : juce::Component
     }
 
     int idleCount{0};
-    void onIdle()
+    // Returns true while a plot may still be on its way, so the editor keeps polling quickly.
+    bool onIdle()
     {
-        if (idleCount == 0)
+        auto sinceRebuild = std::chrono::steady_clock::now() - lastRebuild;
+        if (refinePending && sinceRebuild > std::chrono::milliseconds(150))
         {
-            bool rp{false};
-            {
-                std::unique_lock<std::mutex> l(dataM);
-                rp = lastRepaintReq != repaintReq;
-                lastRepaintReq = repaintReq;
-            }
-            if (rp)
-            {
-                invalidateImage = true;
-                repaint();
-            }
+            refinePending = false;
+            sendPlotRequest(FilterPlotService::Request::FINE);
+        }
+
+        if (idleCount == 0 && plotClient->fetch())
+        {
+            invalidateImage = true;
+            repaint();
         }
         idleCount++;
-        if (idleCount > ((panel.editor.cpuGraphicsMode != PluginEditor::FULL) ? 3 : 0))
+        if (idleCount > ((panel.editor.graphicsMode() != PluginEditor::FULL) ? 3 : 0))
             idleCount = 0;
+
+        return refinePending || sinceRebuild < std::chrono::seconds(1);
     }
     bool invalidateImage{true};
 
+    // Updates arriving close together (a drag on the curve or a knob, automation) get a
+    // draft plot each, and one fine plot once they stop. A lone change goes straight to fine.
+    std::chrono::steady_clock::time_point lastRebuild{};
+    bool refinePending{false};
     void rebuild()
     {
-        std::unique_lock<std::mutex> l(sendM);
-        updateRequest++;
-        auto &fn = panel.editor.patchMainRef.filterNodes[panel.instance];
-        co = fn.cutoff;
-        res = fn.resonance;
-        morph = fn.morph;
-        snapModel = fn.model;
-        snapConfig = fn.config;
-        sendCV.notify_one();
+        auto now = std::chrono::steady_clock::now();
+        auto interacting = now - lastRebuild < std::chrono::milliseconds(100);
+        lastRebuild = now;
+
+        refinePending = interacting;
+        sendPlotRequest(interacting ? FilterPlotService::Request::DRAFT
+                                    : FilterPlotService::Request::FINE);
     }
 
-    float co, res, morph;
-    sst::filtersplusplus::FilterModel snapModel{sst::filtersplusplus::FilterModel::None};
-    sst::filtersplusplus::ModelConfig snapConfig{};
+    void sendPlotRequest(FilterPlotService::Request::Quality q)
+    {
+        auto &fn = panel.editor.patchMainRef.filterNodes[panel.instance];
+        FilterPlotService::Request r;
+        r.model = fn.model;
+        r.config = fn.config;
+        r.cutoff = fn.cutoff;
+        r.resonance = fn.resonance;
+        r.morph = fn.morph;
+        r.quality = q;
+        plotClient->request(r);
+    }
 
     FilterPanel &panel;
-
-    std::vector<float> cX, cY;
-
-    sst::filters::FilterPlotter plotter{14};
 };
 
 FilterPanel::FilterPanel(PluginEditor &ed, int ins)
@@ -815,7 +728,7 @@ void FilterPanel::jogModel(int dir)
     onModelChanged();
 }
 
-void FilterPanel::onIdle() { curve->onIdle(); }
+bool FilterPanel::onIdle() { return curve->onIdle(); }
 
 void FilterPanel::endEdit(int id) { curve->rebuild(); }
 
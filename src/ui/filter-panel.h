@@ -42,7 +42,7 @@ struct FilterPanel : sst::jucegui::components::NamedPanel
     void jogModel(int dir);
     void jogConfig(int dir);
 
-    void onIdle();
+    bool onIdle();
 
     void randomize();
     void resetFilter();
@@ -0,0 +1,201 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "filter-plot-service.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sst/filters/FilterPlotter.h"
+#include "sst/plugininfra/paths.h"
+#include "engine/trace-recorder.h"
+
+namespace baconpaul::twofilters::ui
+{
+struct FilterPlotService::Worker
+{
+    std::unique_ptr<std::thread> thread;
+    sst::filters::FilterPlotter plotter{14};
+    sst::filters::FilterPlotter draftPlotter{11};
+    bool loadsCache{false};
+};
+
+std::shared_ptr<FilterPlotService> FilterPlotService::instance()
+{
+    static std::mutex instanceM;
+    static std::weak_ptr<FilterPlotService> weak;
+
+    std::lock_guard<std::mutex> l(instanceM);
+    auto res = weak.lock();
+    if (!res)
+    {
+        res = std::shared_ptr<FilterPlotService>(new FilterPlotService());
+        weak = res;
+    }
+    return res;
+}
+
+FilterPlotService::FilterPlotService()
+{
+    try
+    {
+        cachePath = sst::plugininfra::paths::bestDocumentsVendorFolderPathFor("BaconPaul",
+                                                                              "Two Filters") /
+                    "FilterResponseCache.bin";
+    }
+    catch (fs::filesystem_error &)
+    {
+    }
+
+    // Plotting is bursty UI work; a couple of threads keep up with any number of curves
+    // without competing with the host's audio threads for every core.
+    auto hc = std::thread::hardware_concurrency();
+    auto nw = std::clamp(hc / 4, 1U, 2U);
+    for (auto i = 0U; i < nw; ++i)
+    {
+        auto w = std::make_unique<Worker>();
+        w->loadsCache = (i == 0);
+        auto *wp = w.get();
+        w->thread = std::make_unique<std::thread>([this, wp]() { run(*wp); });
+        workers.push_back(std::move(w));
+    }
+}
+
+FilterPlotService::~FilterPlotService()
+{
+    running = false;
+    {
+        std::unique_lock<std::mutex> l(queueM);
+        queueCV.notify_all();
+    }
+    for (auto &w : workers)
+        w->thread->join();
+
+    if (!cachePath.empty() && fs::exists(cachePath.parent_path()))
+        cache.save(cachePath);
+}
+
+std::shared_ptr<FilterPlotService::Client> FilterPlotService::makeClient()
+{
+    return std::shared_ptr<Client>(new Client(*this));
+}
+
+void FilterPlotService::schedule(const std::shared_ptr<Client> &c)
+{
+    if (c->hasPending && !c->queued && !c->inFlight)
+    {
+        c->queued = true;
+        ready.push_back(c);
+        queueCV.notify_one();
+    }
+}
+
+void FilterPlotService::run(Worker &w)
+{
+    if (w.loadsCache && !cachePath.empty())
+        cache.load(cachePath);
+
+    while (running)
+    {
+        std::shared_ptr<Client> c;
+        Request r;
+        {
+            std::unique_lock<std::mutex> l(queueM);
+            while (running && ready.empty())
+                queueCV.wait(l);
+            if (!running)
+                break;
+
+            c = ready.front();
+            ready.pop_front();
+            r = c->pending;
+            c->hasPending = false;
+            c->queued = false;
+            c->inFlight = true;
+        }
+
+        Result res;
+        if (r.model == sst::filtersplusplus::FilterModel::None)
+        {
+            res.x = {0.5f, 5.0f};
+            res.y = {0.f, 0.f};
+        }
+        else
+        {
+            auto key =
+                FilterResponseCache::quantise(r.model, r.config, r.cutoff, r.resonance, r.morph);
+
+            // A cached fine curve beats plotting a draft too.
+            if (!cache.lookup(key, res.x, res.y))
+            {
+                auto mo = r.morph;
+                if (sst::filtersplusplus::Filter::coefficientsExtraIsBipolar(r.model, r.config,
+                                                                             0))
+                    mo = mo * 2 - 1;
+
+                auto fine = r.quality == Request::FINE;
+                auto par = sst::filters::FilterPlotParameters();
+                par.freqSmoothOctaves = fine ? 1.0 / 36.0 : 1.0 / 12.0;
+                auto &plotter = fine ? w.plotter : w.draftPlotter;
+                TF_TRACE_SCOPE("ui", fine ? "FilterPlotService::plotFine"
+                                          : "FilterPlotService::plotDraft");
+                auto crv = plotter.plotFilterMagnitudeResponse(r.model, r.config, r.cutoff,
+                                                               r.resonance, mo, 0, 0, par);
+                res.x = std::move(crv.first);
+                for (auto &x : res.x)
+                    x = (x > 0 ? log10(x) : 0);
+                res.y = std::move(crv.second);
+
+                if (fine)
+                    cache.insert(key, res.x, res.y);
+            }
+        }
+        if (r.quality == Request::DRAFT || r.generation == c->latestGeneration.load())
+            c->publish(std::move(res));
+
+        {
+            std::unique_lock<std::mutex> l(queueM);
+            c->inFlight = false;
+            schedule(c);
+        }
+    }
+}
+
+void FilterPlotService::Client::request(const Request &r)
+{
+    std::unique_lock<std::mutex> l(service.queueM);
+    pending = r;
+    pending.generation = ++latestGeneration;
+    hasPending = true;
+    service.schedule(shared_from_this());
+}
+
+void FilterPlotService::Client::publish(Result &&r)
+{
+    // Only ever one worker per client at a time (inFlight), so this is single producer.
+    slots[writeSlot] = std::move(r);
+    auto prior = middle.exchange(writeSlot | freshBit, std::memory_order_acq_rel);
+    writeSlot = prior & ~freshBit;
+}
+
+bool FilterPlotService::Client::fetch()
+{
+    if (!(middle.load(std::memory_order_acquire) & freshBit))
+        return false;
+    auto prior = middle.exchange(readSlot, std::memory_order_acq_rel);
+    readSlot = prior & ~freshBit;
+    return true;
+}
+} // namespace baconpaul::twofilters::ui
@@ -0,0 +1,128 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_UI_FILTER_PLOT_SERVICE_H
+#define BACONPAUL_TWOFILTERS_UI_FILTER_PLOT_SERVICE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sst/filters++.h"
+#include "filesystem/import.h"
+#include "filter-response-cache.h"
+
+namespace baconpaul::twofilters::ui
+{
+/*
+ * One set of filter response plotting threads for the whole process, shared by every open
+ * editor. Each FilterCurve holds a Client. Requests coalesce: a client has at most one plot
+ * in flight and one pending, and a newer request simply replaces the pending one. A worker
+ * publishes into the client's triple buffer, so the UI picks results up without a lock.
+ * Fine curves go through a FilterResponseCache, so settings seen before (in this session or
+ * a previous one) come back without plotting.
+ */
+struct FilterPlotService
+{
+    struct Request
+    {
+        sst::filtersplusplus::FilterModel model{sst::filtersplusplus::FilterModel::None};
+        sst::filtersplusplus::ModelConfig config{};
+        float cutoff{0}, resonance{0}, morph{0};
+
+        // DRAFT is a small FFT with coarse smoothing, cheap enough to follow a drag; FINE is
+        // the full resolution curve, asked for once things settle.
+        enum Quality
+        {
+            DRAFT,
+            FINE
+        } quality{FINE};
+        uint64_t generation{0}; // assigned by Client::request
+    };
+
+    struct Result
+    {
+        std::vector<float> x, y; // x is log10(hz), y is dB
+    };
+
+    struct Client : std::enable_shared_from_this<Client>
+    {
+        // Main thread. Replaces any not-yet-started request.
+        void request(const Request &r);
+
+        // Main thread. True if a newer result was published since the last call, in which
+        // case current() now refers to it.
+        bool fetch();
+        const Result &current() const { return slots[readSlot]; }
+
+      private:
+        friend struct FilterPlotService;
+        explicit Client(FilterPlotService &s) : service(s) {}
+
+        void publish(Result &&r);
+
+        FilterPlotService &service;
+
+        // Newest request generation. A FINE plot that finishes behind a newer request is
+        // stale and dropped rather than shown; a DRAFT one is shown since it is still closer
+        // than what is on screen. (A plot can't be abandoned part way through the FFT.)
+        std::atomic<uint64_t> latestGeneration{0};
+
+        // guarded by service.queueM
+        Request pending;
+        bool hasPending{false}, queued{false}, inFlight{false};
+
+        // Triple buffer: the worker owns writeSlot, the UI owns readSlot, and the third is
+        // exchanged through `middle`, whose freshBit says it holds an unread result.
+        static constexpr uint8_t freshBit{4};
+        std::array<Result, 3> slots;
+        std::atomic<uint8_t> middle{1};
+        uint8_t writeSlot{0}, readSlot{2};
+    };
+
+    // The process-wide instance, created on first use and torn down when the last holder
+    // lets go. Each plugin holds it from its first editor on, so that is the last plugin.
+    static std::shared_ptr<FilterPlotService> instance();
+
+    // The caller must keep the service alive (via instance()) for the life of the client.
+    std::shared_ptr<Client> makeClient();
+
+    ~FilterPlotService();
+
+  private:
+    FilterPlotService();
+
+    struct Worker;
+    void run(Worker &w);
+    void schedule(const std::shared_ptr<Client> &c); // with queueM held
+
+    std::mutex queueM;
+    std::condition_variable queueCV;
+    std::deque<std::shared_ptr<Client>> ready;
+    std::atomic<bool> running{true};
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Fine curves only. Loaded by the first worker as it starts, saved on teardown.
+    FilterResponseCache cache;
+    fs::path cachePath;
+};
+} // namespace baconpaul::twofilters::ui
+#endif // BACONPAUL_TWOFILTERS_UI_FILTER_PLOT_SERVICE_H
@@ -0,0 +1,216 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "filter-response-cache.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "configuration.h"
+
+namespace baconpaul::twofilters::ui
+{
+namespace
+{
+// Cutoff is in semitones, so 1/16 of one; resonance and morph run 0..1 (or -1..1).
+constexpr float cutoffSteps{16.f}, unitSteps{512.f};
+constexpr char fileMagic[4]{'T', 'F', 'R', 'C'};
+constexpr uint32_t fileVersion{1};
+
+template <typename T> void writePod(std::ofstream &o, const T &v)
+{
+    o.write(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+template <typename T> bool readPod(std::ifstream &i, T &v)
+{
+    return (bool)i.read(reinterpret_cast<char *>(&v), sizeof(T));
+}
+} // namespace
+
+FilterResponseCache::Key
+FilterResponseCache::quantise(sst::filtersplusplus::FilterModel model,
+                              const sst::filtersplusplus::ModelConfig &config, float &cutoff,
+                              float &resonance, float &morph)
+{
+    Key k;
+    k.model = (int32_t)model;
+    k.pt = (int32_t)config.pt;
+    k.st = (int32_t)config.st;
+    k.dt = (int32_t)config.dt;
+    k.mt = (int32_t)config.mt;
+    k.cutoff = (int32_t)std::round(cutoff * cutoffSteps);
+    k.resonance = (int32_t)std::round(resonance * unitSteps);
+    k.morph = (int32_t)std::round(morph * unitSteps);
+
+    cutoff = k.cutoff / cutoffSteps;
+    resonance = k.resonance / unitSteps;
+    morph = k.morph / unitSteps;
+    return k;
+}
+
+size_t FilterResponseCache::KeyHash::operator()(const Key &k) const
+{
+    size_t h{0};
+    for (auto v : {k.model, k.pt, k.st, k.dt, k.mt, k.cutoff, k.resonance, k.morph})
+        h = h * 1000003 ^ std::hash<int32_t>()(v);
+    return h;
+}
+
+bool FilterResponseCache::lookup(const Key &k, std::vector<float> &x, std::vector<float> &y)
+{
+    std::lock_guard<std::mutex> l(m);
+    auto it = index.find(k);
+    if (it == index.end())
+        return false;
+
+    lru.splice(lru.begin(), lru, it->second);
+    x = it->second->x;
+    y = it->second->y;
+    return true;
+}
+
+void FilterResponseCache::insert(const Key &k, const std::vector<float> &x,
+                                 const std::vector<float> &y)
+{
+    std::lock_guard<std::mutex> l(m);
+    insertLocked({k, x, y});
+    dirty = true;
+}
+
+void FilterResponseCache::insertLocked(Entry &&e)
+{
+    if (e.x.size() > maxPoints)
+        return;
+
+    auto prior = index.find(e.key);
+    if (prior != index.end())
+    {
+        points -= prior->second->x.size();
+        lru.erase(prior->second);
+        index.erase(prior);
+    }
+
+    points += e.x.size();
+    lru.push_front(std::move(e));
+    index[lru.front().key] = lru.begin();
+
+    while (points > maxPoints && !lru.empty())
+    {
+        points -= lru.back().x.size();
+        index.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+void FilterResponseCache::load(const fs::path &p)
+{
+    std::ifstream i(p, std::ios::binary);
+    if (!i.is_open())
+        return;
+
+    char magic[4];
+    uint32_t ver{0}, hashLen{0};
+    if (!i.read(magic, 4) || memcmp(magic, fileMagic, 4) != 0 || !readPod(i, ver) ||
+        ver != fileVersion || !readPod(i, hashLen) || hashLen > 256)
+        return;
+
+    std::string hash(hashLen, '\0');
+    if (!i.read(hash.data(), hashLen) ||
+        hash != sst::plugininfra::VersionInformation::git_commit_hash)
+        return;
+
+    // A saved cache never holds more than maxPoints, so anything past that is a bad file.
+    // count is untrusted, so entries grow as they are read rather than being reserved.
+    uint32_t count{0};
+    if (!readPod(i, count) || count > maxPoints)
+        return;
+
+    // Entries are stored most recent first; insert oldest first to rebuild the LRU order.
+    std::vector<Entry> entries;
+    size_t total{0};
+    for (uint32_t e = 0; e < count; ++e)
+    {
+        Entry en;
+        uint32_t n{0};
+        if (!readPod(i, en.key) || !readPod(i, n) || n > maxPoints - total)
+            return;
+        total += n;
+        en.x.resize(n);
+        en.y.resize(n);
+        if (!i.read(reinterpret_cast<char *>(en.x.data()), n * sizeof(float)) ||
+            !i.read(reinterpret_cast<char *>(en.y.data()), n * sizeof(float)))
+            return;
+        entries.push_back(std::move(en));
+    }
+
+    std::lock_guard<std::mutex> l(m);
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+    {
+        if (index.find(it->key) == index.end())
+            insertLocked(std::move(*it));
+    }
+}
+
+void FilterResponseCache::save(const fs::path &p)
+{
+    std::lock_guard<std::mutex> l(m);
+    if (!dirty)
+        return;
+
+    // Write beside the cache and move it into place, so a failed write leaves the old one
+    auto tmp = p;
+    tmp += ".tmp";
+    std::ofstream o(tmp, std::ios::binary);
+    if (!o.is_open())
+    {
+        SQLOG("Unable to write filter response cache to " << tmp.u8string());
+        return;
+    }
+
+    std::string hash = sst::plugininfra::VersionInformation::git_commit_hash;
+    o.write(fileMagic, 4);
+    writePod(o, fileVersion);
+    writePod(o, (uint32_t)hash.size());
+    o.write(hash.data(), hash.size());
+    writePod(o, (uint32_t)lru.size());
+    for (const auto &e : lru)
+    {
+        writePod(o, e.key);
+        writePod(o, (uint32_t)e.x.size());
+        o.write(reinterpret_cast<const char *>(e.x.data()), e.x.size() * sizeof(float));
+        o.write(reinterpret_cast<const char *>(e.y.data()), e.y.size() * sizeof(float));
+    }
+    o.close();
+
+    std::error_code ec;
+    if (!o)
+    {
+        SQLOG("Unable to write filter response cache to " << tmp.u8string());
+        fs::remove(tmp, ec);
+        return;
+    }
+    fs::rename(tmp, p, ec);
+    if (ec)
+    {
+        SQLOG("Unable to move filter response cache to " << p.u8string() << ": "
+                                                         << ec.message());
+        fs::remove(tmp, ec);
+        return;
+    }
+    dirty = false;
+}
+} // namespace baconpaul::twofilters::ui
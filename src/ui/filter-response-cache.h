@@ -0,0 +1,84 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_UI_FILTER_RESPONSE_CACHE_H
+#define BACONPAUL_TWOFILTERS_UI_FILTER_RESPONSE_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "filesystem/import.h"
+#include "sst/filters++.h"
+
+namespace baconpaul::twofilters::ui
+{
+/*
+ * Finished filter response curves, keyed on the model, config and the controls quantised
+ * finely enough that neighbouring keys plot indistinguishably. Bounded by total point count
+ * with least-recently-used eviction, and saved to / loaded from a single binary file so a
+ * new session starts warm. Thread safe; the plot workers share one.
+ */
+struct FilterResponseCache
+{
+    struct Key
+    {
+        int32_t model{0}, pt{0}, st{0}, dt{0}, mt{0};
+        int32_t cutoff{0}, resonance{0}, morph{0}; // quantised, see quantise()
+
+        bool operator==(const Key &o) const
+        {
+            return model == o.model && pt == o.pt && st == o.st && dt == o.dt && mt == o.mt &&
+                   cutoff == o.cutoff && resonance == o.resonance && morph == o.morph;
+        }
+    };
+
+    // Builds the key and snaps the controls to it, so what gets plotted is exactly what the
+    // key describes.
+    static Key quantise(sst::filtersplusplus::FilterModel model,
+                        const sst::filtersplusplus::ModelConfig &config, float &cutoff,
+                        float &resonance, float &morph);
+
+    bool lookup(const Key &k, std::vector<float> &x, std::vector<float> &y);
+    void insert(const Key &k, const std::vector<float> &x, const std::vector<float> &y);
+
+    // A file written by a different build is ignored, since plotter changes alter curves.
+    void load(const fs::path &p);
+    void save(const fs::path &p);
+
+    static constexpr size_t maxPoints{1024 * 1024}; // x and y each; about 8mb of curves
+
+  private:
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const;
+    };
+    struct Entry
+    {
+        Key key;
+        std::vector<float> x, y;
+    };
+    void insertLocked(Entry &&e);
+
+    std::mutex m;
+    std::list<Entry> lru; // most recently used at the front
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    size_t points{0};
+    bool dirty{false};
+};
+} // namespace baconpaul::twofilters::ui
+#endif // BACONPAUL_TWOFILTERS_UI_FILTER_RESPONSE_CACHE_H
@@ -18,6 +18,7 @@
 #include "sst/plugininfra/version_information.h"
 #include "sst/clap_juce_shim/menu_helper.h"
 #include "sst/plugininfra/misc_platform.h"
+#include "engine/trace-recorder.h"
 
 #include "sst/jucegui/components/Label.h"
 
@@ -46,9 +47,13 @@ static constexpr sheet_t::Class PatchMenu("twofilters.patch-menu");
 
 PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
                            Engine::mainToAudioQueue_T &utoa, std::atomic<bool> &editorActiveIn,
-                           std::atomic<uint32_t> &uiForceRebuildIn, const clap_host_t *h)
+                           std::atomic<uint32_t> &uiForceRebuildIn,
+                           std::atomic<bool> &telemetryAvailableIn, const clap_host_t *h,
+                           std::shared_ptr<presets::PresetManager> sharedPresetManager)
     : jcmp::WindowPanel(true), patchMainRef(patchMain), audioToMain(atou), mainToAudio(utoa),
-      editorActive(editorActiveIn), uiForceRebuild(uiForceRebuildIn), clapHost(h)
+      editorActive(editorActiveIn), uiForceRebuild(uiForceRebuildIn),
+      telemetryAvailable(telemetryAvailableIn), clapHost(h),
+      presetManager(std::move(sharedPresetManager))
 {
     lastForceRebuild = uiForceRebuild.load();
     setTitle("Two Filters");
@@ -66,12 +71,6 @@ PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
             ->getFont(jcmp::MenuButton::Styles::styleClass, jcmp::MenuButton::Styles::labelfont)
             .withHeight(18));
 
-#if INCLUDE_DEBUG_PANEL
-    debugPanel = std::make_unique<DebugPanel>(*this);
-    debugPanel->hasHamburger = false;
-    addAndMakeVisible(*debugPanel);
-#endif
-
     for (int i = 0; i < numFilters; ++i)
     {
         filterPanel[i] = std::make_unique<FilterPanel>(*this, i);
@@ -88,7 +87,7 @@ PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
     addAndMakeVisible(*routingPanel);
 
     idleTimer = std::make_unique<IdleTimer>(*this);
-    idleTimer->startTimer(1000. / 60.);
+    idleTimer->startTimerHz(activeIdleHz);
     // Idle now owns draining audioToMain; mark the editor active so the audio thread stops
     // requesting main-thread drains and gates VU/LFO traffic on us being here.
     editorActive = true;
@@ -96,7 +95,10 @@ PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
     toolTip = std::make_unique<jcmp::ToolTip>();
     addChildComponent(*toolTip);
 
-    presetManager = std::make_unique<presets::PresetManager>(clapHost);
+    if (!presetManager)
+        presetManager = std::make_shared<presets::PresetManager>(clapHost);
+    else
+        presetManager->processUserPatchChanges(); // catch up on edits while we were closed
     presetManager->onPresetLoaded = [this](auto s)
     {
         this->postPatchChange(s);
@@ -115,6 +117,21 @@ PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
     setPatchNameDisplay();
     sst::jucegui::component_adapters::setTraversalId(presetButton.get(), 174);
 
+#if JUCE_LINUX
+    // JUCE routes fd callbacks through the shim to the host's posix-fd support, so changes
+    // to the user Patches folder land on the main thread without any polling.
+    if (presetManager->userPatchWatcher)
+    {
+        userPatchWatchFd = presetManager->userPatchWatcher->fileDescriptor();
+        juce::LinuxEventLoop::registerFdCallback(userPatchWatchFd,
+                                                 [w = juce::Component::SafePointer(this)](int)
+                                                 {
+                                                     if (w)
+                                                         w->onUserPatchesChanged();
+                                                 });
+    }
+#endif
+
     // this needs a cleanup
     defaultsProvider = std::make_unique<defaultsProvider_t>(presetManager->userPath, "TwoFilters",
                                                             defaultName, [](auto e, auto b)
@@ -132,6 +149,8 @@ PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
 
     cpuGraphicsMode = (PluginEditor::GraphicsMode)defaultsProvider->getUserDefaultValue(
         Defaults::useLowCpuGraphics, PluginEditor::FULL);
+    presetManager->transitionMs =
+        defaultsProvider->getUserDefaultValue(Defaults::presetTransitionMs, 0);
 
     auto pzf = defaultsProvider->getUserDefaultValue(Defaults::zoomLevel, 100);
     zoomFactor = pzf * 0.01;
@@ -151,6 +170,12 @@ PluginEditor::PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
 PluginEditor::~PluginEditor()
 {
     juce::PopupMenu::dismissAllActiveMenus();
+    presetManager->onPresetLoaded = nullptr;
+
+#if JUCE_LINUX
+    if (userPatchWatchFd >= 0)
+        juce::LinuxEventLoop::unregisterFdCallback(userPatchWatchFd);
+#endif
 
     // Hand draining of audioToMain back to onMainThread, then stop idling.
     editorActive = false;
@@ -162,6 +187,9 @@ PluginEditor::~PluginEditor()
 
 void PluginEditor::idle()
 {
+    TF_TRACE_SCOPE("ui", "PluginEditor::idle");
+    bool active{false};
+
     // An out-of-band load (host stateLoad) wrote patchMain directly and bumped the counter.
     // patchMainRef already holds the new values; refresh every widget from it.
     auto fr = uiForceRebuild.load();
@@ -169,8 +197,34 @@ void PluginEditor::idle()
     {
         lastForceRebuild = fr;
         rebuildFromPatchMain();
+        active = true;
+    }
+
+    // Cleared before draining, so a push that races the drain just costs one empty pass.
+    if (telemetryAvailable.exchange(false, std::memory_order_acq_rel))
+    {
+        drainAudioToMain();
+        active = true;
     }
 
+    auto showing = isShowing();
+    if (showing)
+    {
+        applyPendingRefreshes();
+        for (auto &f : filterPanel)
+            active = f->onIdle() || active;
+    }
+
+    quietFrames = active ? 0 : std::min(quietFrames + 1, framesBeforeQuiet);
+    auto hz = !showing                          ? hiddenIdleHz
+              : quietFrames < framesBeforeQuiet ? activeIdleHz
+                                                : quietIdleHz;
+    if (idleTimer->getTimerInterval() != 1000 / hz)
+        idleTimer->startTimerHz(hz);
+}
+
+void PluginEditor::drainAudioToMain()
+{
     auto aum = audioToMain.pop();
     while (aum.has_value())
     {
@@ -179,39 +233,40 @@ void PluginEditor::idle()
         // and filter config are UI-owned and never arrive on audioToMain anymore.
         if (Engine::handleAudioToMainMessage(patchMainRef, *aum))
         {
-            auto rit = componentRefreshByID.find(aum->paramId);
-            if (rit != componentRefreshByID.end())
-                rit->second();
-            auto pit = componentByID.find(aum->paramId);
-            if (pit != componentByID.end() && pit->second)
-                pit->second->repaint();
+            pendingRefreshIDs.insert(aum->paramId);
         }
         else if (aum->action == Engine::AudioToMainMsg::UPDATE_VU)
         {
-            vuMeter->setLevels(aum->value, aum->value2);
+            pendingVu = *aum;
         }
         else if (aum->action == Engine::AudioToMainMsg::SEND_SAMPLE_RATE)
         {
             sampleRate = aum->value;
-            repaint();
+            pendingRepaint = true;
         }
         else if (aum->action == Engine::AudioToMainMsg::UPDATE_LFOSTEP)
         {
-            if (aum->paramId == 0)
-            {
-                stepLFOPanel[0]->setCurrentStep(aum->value);
-                stepLFOPanel[1]->setCurrentStep(aum->value2);
-            }
-            if (aum->paramId == 1)
-            {
-                stepLFOPanel[0]->setCurrentPhase(aum->value);
-                stepLFOPanel[1]->setCurrentPhase(aum->value2);
-            }
-            if (aum->paramId == 2)
+            if (aum->paramId < pendingLfo.size())
+                pendingLfo[aum->paramId] = *aum;
+        }
+#if TWOFILTERS_DSP_TIMING
+        else if (aum->action == Engine::AudioToMainMsg::UPDATE_DSP_TIMING)
+        {
+            if (aum->paramId < 4)
             {
-                stepLFOPanel[0]->setCurrentLevel(aum->value);
-                stepLFOPanel[1]->setCurrentLevel(aum->value2);
+                dspTimingStats[aum->paramId][0] = aum->value;
+                dspTimingStats[aum->paramId][1] = aum->value2;
             }
+#if INCLUDE_DEBUG_PANEL
+            if (debugPanel)
+                debugPanel->repaint();
+#endif
+        }
+#endif
+        else if (aum->action == Engine::AudioToMainMsg::UPDATE_CPU_GOVERNOR)
+        {
+            cpuGovernorLevel = aum->paramId;
+            pendingRepaint = true;
         }
         else
         {
@@ -219,13 +274,65 @@ void PluginEditor::idle()
         }
         aum = audioToMain.pop();
     }
+}
 
-    for (auto &f : filterPanel)
-        f->onIdle();
+void PluginEditor::applyPendingRefreshes()
+{
+    for (auto id : pendingRefreshIDs)
+    {
+        auto rit = componentRefreshByID.find(id);
+        if (rit != componentRefreshByID.end())
+            rit->second();
+        auto pit = componentByID.find(id);
+        if (pit != componentByID.end() && pit->second)
+            pit->second->repaint();
+    }
+    pendingRefreshIDs.clear();
+
+    if (pendingVu.has_value())
+    {
+        vuMeter->setLevels(pendingVu->value, pendingVu->value2);
+        pendingVu.reset();
+    }
+
+    if (pendingLfo[0].has_value())
+    {
+        stepLFOPanel[0]->setCurrentStep(pendingLfo[0]->value);
+        stepLFOPanel[1]->setCurrentStep(pendingLfo[0]->value2);
+    }
+    if (pendingLfo[1].has_value())
+    {
+        stepLFOPanel[0]->setCurrentPhase(pendingLfo[1]->value);
+        stepLFOPanel[1]->setCurrentPhase(pendingLfo[1]->value2);
+    }
+    if (pendingLfo[2].has_value())
+    {
+        stepLFOPanel[0]->setCurrentLevel(pendingLfo[2]->value);
+        stepLFOPanel[1]->setCurrentLevel(pendingLfo[2]->value2);
+    }
+    for (auto &l : pendingLfo)
+        l.reset();
+
+    if (pendingRepaint)
+    {
+        pendingRepaint = false;
+        repaint();
+    }
 }
 
 void PluginEditor::paint(juce::Graphics &g)
 {
+    TF_TRACE_SCOPE("ui", "PluginEditor::paint");
+    if (!openLatencyReported)
+    {
+        openLatencyReported = true;
+        auto took = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - openStart);
+        if (took > openLatencyTarget || debugLevel > 0)
+            SQLOG("Editor open took " << took.count() << "ms (target "
+                                      << openLatencyTarget.count() << "ms)");
+    }
+
     jcmp::WindowPanel::paint(g);
     auto ft = style()->getFont(jcmp::Label::Styles::styleClass, jcmp::Label::Styles::labelfont);
 
@@ -261,6 +368,8 @@ void PluginEditor::paint(juce::Graphics &g)
 
     auto bi = os + " " + sst::plugininfra::VersionInformation::git_commit_hash;
     bi += fmt::format(" @ {:.1f}k", sampleRate / 1000.0);
+    if (cpuGovernorLevel != CpuGovernor::Full)
+        bi = fmt::format("CPU: {} | ", CpuGovernor::levelName(cpuGovernorLevel)) + bi;
     g.drawText(bi, getLocalBounds().reduced(3, 3), juce::Justification::bottomRight);
 
     g.drawText(sst::plugininfra::VersionInformation::git_implied_display_version,
@@ -322,7 +431,8 @@ void PluginEditor::resized()
     stepLFOPanel[1]->setBounds(sp.reduced(panelMargin));
 
 #if INCLUDE_DEBUG_PANEL
-    debugPanel->setBounds(ma.reduced(panelMargin).withTrimmedTop(250));
+    if (debugPanel)
+        debugPanel->setBounds(ma.reduced(panelMargin).withTrimmedTop(250));
 #endif
 }
 
@@ -609,6 +719,23 @@ void PluginEditor::showPresetPopup()
     p.addSeparator();
     p.addSubMenu("Factory Presets", f);
     p.addSubMenu("User Presets", u);
+
+    auto ptm = juce::PopupMenu();
+    for (auto ms : {0, 5, 20, 50, 200})
+    {
+        auto nm = ms == 0 ? std::string("Stop and Reset (No Crossfade)")
+                          : "Crossfade over " + std::to_string(ms) + " ms";
+        ptm.addItem(nm, true, presetManager->transitionMs == ms,
+                    [w = juce::Component::SafePointer(this), ms]()
+                    {
+                        if (!w)
+                            return;
+                        w->defaultsProvider->updateUserDefaultValue(Defaults::presetTransitionMs,
+                                                                    ms);
+                        w->presetManager->transitionMs = ms;
+                    });
+    }
+    p.addSubMenu("Preset Transition", ptm);
     p.addSeparator();
 
     p.addItem("Reset to Init",
@@ -716,6 +843,25 @@ void PluginEditor::showPresetPopup()
                     });
     }
     uim.addSeparator();
+    auto gov = patchMainRef.routingNode.cpuGovernor.value > 0.5f;
+    uim.addItem("CPU Governor (Live Use)", true, gov,
+                [w = juce::Component::SafePointer(this), gov]()
+                {
+                    if (!w)
+                        return;
+                    w->setAndSendParamValue(w->patchMainRef.routingNode.cpuGovernor,
+                                            gov ? 0.f : 1.f);
+                });
+    auto oq = patchMainRef.routingNode.offlineQuality.value > 0.5f;
+    uim.addItem("Offline Render Quality (Bounce)", true, oq,
+                [w = juce::Component::SafePointer(this), oq]()
+                {
+                    if (!w)
+                        return;
+                    w->setAndSendParamValue(w->patchMainRef.routingNode.offlineQuality,
+                                            oq ? 0.f : 1.f);
+                });
+    uim.addSeparator();
     uim.addItem("Dark Mode", true, !isLight,
                 [w = juce::Component::SafePointer(this)]()
                 {
@@ -742,6 +888,36 @@ void PluginEditor::showPresetPopup()
                         w->toggleDebug();
                 });
 
+    if (TraceRecorder::isRecording())
+    {
+        uim.addItem("Stop and Save Trace",
+                    [w = juce::Component::SafePointer(this)]()
+                    {
+                        if (!w)
+                            return;
+                        auto dir = w->presetManager->userPath / "Traces";
+                        try
+                        {
+                            fs::create_directories(dir);
+                        }
+                        catch (fs::filesystem_error &e)
+                        {
+                            SQLOG("Unable to create trace dir " << e.what());
+                        }
+                        auto nm = juce::Time::getCurrentTime().formatted("%Y-%m-%d-%H%M%S");
+                        auto to = dir / ("TwoFilters-" + nm.toStdString() + ".json");
+                        if (TraceRecorder::dumpChromeJson(to))
+                            juce::AlertWindow::showMessageBoxAsync(
+                                juce::AlertWindow::InfoIcon, "Trace Saved",
+                                "Trace written to " + to.u8string() +
+                                    ". Open it in chrome://tracing or ui.perfetto.dev.");
+                    });
+    }
+    else
+    {
+        uim.addItem("Start Trace Recording", []() { TraceRecorder::start(); });
+    }
+
 #if JUCE_WINDOWS
     auto swr = defaultsProvider->getUserDefaultValue(Defaults::useSoftwareRenderer, false);
 
@@ -891,6 +1067,14 @@ void PluginEditor::setPatchNameDisplay()
     presetButton->repaint();
 }
 
+void PluginEditor::onUserPatchesChanged()
+{
+    if (!presetManager->processUserPatchChanges())
+        return;
+    // The binding holds an index into the user list, which may have shifted.
+    setPatchNameDisplay();
+}
+
 void PluginEditor::markPatchDirty()
 {
     if (patchMainRef.dirty)
@@ -1024,6 +1208,19 @@ bool PluginEditor::toggleDebug()
         debugLevel = -1;
     SQLOG("Started debug session");
     SQLOG("If you are on windows and you close this window it may end your entire session");
+
+#if INCLUDE_DEBUG_PANEL
+    // A knob per leftover param is a lot to build for something rarely opened.
+    if (debugLevel > 0 && !debugPanel)
+    {
+        debugPanel = std::make_unique<DebugPanel>(*this);
+        debugPanel->hasHamburger = false;
+        addAndMakeVisible(*debugPanel);
+        resized();
+    }
+    if (debugPanel)
+        debugPanel->setVisible(debugLevel > 0);
+#endif
     return debugLevel > 0;
 }
 
@@ -1037,6 +1234,8 @@ void PluginEditor::onStyleChanged()
 void PluginEditor::pushFilterSetup(int instance)
 {
     auto &fn = patchMainRef.filterNodes[instance];
+    if (prepareFilter)
+        prepareFilter(instance);
 
     Engine::MainToAudioMsg msg;
     msg.action = Engine::MainToAudioMsg::SET_FILTER_MODEL;
@@ -16,7 +16,10 @@
 #ifndef BACONPAUL_TWOFILTERS_UI_PLUGIN_EDITOR_H
 #define BACONPAUL_TWOFILTERS_UI_PLUGIN_EDITOR_H
 
+#include <chrono>
 #include <functional>
+#include <optional>
+#include <unordered_set>
 #include <utility>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "sst/jucegui/style/JUCELookAndFeelAdapter.h"
@@ -65,11 +68,14 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
     std::atomic<bool> &editorActive;
     std::atomic<uint32_t> &uiForceRebuild;
     uint32_t lastForceRebuild{0};
+    std::atomic<bool> &telemetryAvailable;
     const clap_host_t *clapHost{nullptr};
 
     PluginEditor(Patch &patchMain, Engine::audioToMainQueue_t &atou,
                  Engine::mainToAudioQueue_T &utoa, std::atomic<bool> &editorActive,
-                 std::atomic<uint32_t> &uiForceRebuild, const clap_host_t *ch);
+                 std::atomic<uint32_t> &uiForceRebuild, std::atomic<bool> &telemetryAvailable,
+                 const clap_host_t *ch,
+                 std::shared_ptr<presets::PresetManager> sharedPresetManager = nullptr);
     virtual ~PluginEditor();
 
     // Rebuild every widget from patchMainRef (== patchMain) after an out-of-band load.
@@ -81,8 +87,28 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
     void paint(juce::Graphics &g) override;
     void resized() override;
 
+    /*
+     * Idle only drains audioToMain when the engine has flagged telemetry, and gathers what
+     * it drains into the pending state below: one refresh per touched param and only the
+     * latest VU and LFO values, applied once per frame. While hidden the pending state just
+     * accumulates. The timer drops from active to quiet after a spell with nothing to do,
+     * and to hidden while the editor isn't showing.
+     */
     void idle();
+    void drainAudioToMain();
+    void applyPendingRefreshes();
     std::unique_ptr<juce::Timer> idleTimer;
+    static constexpr int activeIdleHz{60}, quietIdleHz{15}, hiddenIdleHz{4};
+    static constexpr int framesBeforeQuiet{30};
+    int quietFrames{0};
+
+    std::unordered_set<uint32_t> pendingRefreshIDs;
+    std::optional<Engine::AudioToMainMsg> pendingVu;
+    std::array<std::optional<Engine::AudioToMainMsg>, 3> pendingLfo;
+    bool pendingRepaint{false};
+#if TWOFILTERS_DSP_TIMING
+    float dspTimingStats[4][2]{}; // indexed by the UPDATE_DSP_TIMING paramId
+#endif
 
 #if INCLUDE_DEBUG_PANEL
     std::unique_ptr<DebugPanel> debugPanel;
@@ -92,7 +118,9 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
     std::array<std::unique_ptr<StepLFOPanel>, numStepLFOs> stepLFOPanel;
     std::unique_ptr<RoutingPanel> routingPanel;
 
-    std::unique_ptr<presets::PresetManager> presetManager;
+    // Usually owned by the plugin and shared across editor opens, so reopening skips the
+    // user folder scan; the editor makes its own only if it isn't handed one.
+    std::shared_ptr<presets::PresetManager> presetManager;
     std::unique_ptr<PresetDataBinding> presetDataBinding;
     std::unique_ptr<jcmp::JogUpDownButton> presetButton;
 
@@ -103,6 +131,8 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
     void postPatchChange(const std::string &displayName);
     void resetToDefault();
     void setPatchNameDisplay();
+    void onUserPatchesChanged();
+    int userPatchWatchFd{-1};
     // The editor owns dirty state now (patchMain is shared). Mark patchMain dirty on a user
     // edit and light the indicator directly — no audio-thread round-trip.
     void markPatchDirty();
@@ -133,6 +163,15 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
         REDUCES = 1,
         MINIMAL = 2
     } cpuGraphicsMode{FULL};
+    // The engine's CPU governor level, from UPDATE_CPU_GOVERNOR; at LowTelemetry the plots
+    // drop to reduced graphics too
+    uint32_t cpuGovernorLevel{CpuGovernor::Full};
+    GraphicsMode graphicsMode() const
+    {
+        if (cpuGovernorLevel >= CpuGovernor::LowTelemetry && cpuGraphicsMode == FULL)
+            return REDUCES;
+        return cpuGraphicsMode;
+    }
 
     std::unique_ptr<jcmp::ToolTip> toolTip;
     void showTooltipOn(juce::Component *c);
@@ -160,6 +199,11 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
     void setZoomFactor(float zf);
     float zoomFactor{1.0f};
     std::function<void(float)> onZoomChanged{nullptr};
+    // Set by the plugin, which owns the engine; a line per subsystem for the debug panel.
+    std::function<std::string()> describeMemory{nullptr};
+    // Also set by the plugin: builds the filter pushFilterSetup is about to send, off the
+    // audio thread, so the change crossfades in rather than resetting there.
+    std::function<void(int)> prepareFilter{nullptr};
     bool toggleDebug();
 
     std::unique_ptr<jcmp::VUMeter> vuMeter;
@@ -170,6 +214,11 @@ struct PluginEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<Plu
 
     float sampleRate{0};
 
+    // Construction through first paint, logged when over target (or always with debug on).
+    static constexpr std::chrono::milliseconds openLatencyTarget{100};
+    std::chrono::steady_clock::time_point openStart{std::chrono::steady_clock::now()};
+    bool openLatencyReported{false};
+
     void requestParamsFlush();
     const clap_host_params_t *clapParamsExtension{nullptr};
 };
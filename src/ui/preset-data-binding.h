@@ -91,8 +91,7 @@ struct PresetDataBinding : sst::jucegui::data::Discrete
         auto fp = f - 1;
         if (fp < pm.factoryPatchVector.size())
         {
-            pm.loadFactoryPreset(patch, mainToAudio, pm.factoryPatchVector[fp].first,
-                                 pm.factoryPatchVector[fp].second);
+            pm.loadFactoryPreset(patch, mainToAudio, (size_t)fp);
         }
         fp -= pm.factoryPatchVector.size();
         if (fp < pm.userPatches.size())
@@ -66,6 +66,11 @@ RoutingPanel::RoutingPanel(PluginEditor &ed)
     fbPowerD->onGuiSetValue = [this]() { editor.resetEnablement(); };
     editor.componentRefreshByID[rn.feedbackPower.meta.id] = [this]() { editor.resetEnablement(); };
 
+    createComponent(editor, *this, rn.feedbackEco, feedbackEcoT, feedbackEcoD);
+    feedbackEcoT->setDrawMode(sst::jucegui::components::ToggleButton::DrawMode::LABELED);
+    feedbackEcoT->setLabel("Eco");
+    addAndMakeVisible(*feedbackEcoT);
+
     createComponent(editor, *this, rn.noisePower, noisePowerT, noisePowerD);
     noisePowerT->setDrawMode(sst::jucegui::components::ToggleButton::DrawMode::GLYPH);
     noisePowerT->setGlyph(sst::jucegui::components::GlyphPainter::POWER);
@@ -77,6 +82,19 @@ RoutingPanel::RoutingPanel(PluginEditor &ed)
     oversampleT->setDrawMode(sst::jucegui::components::ToggleButton::DrawMode::LABELED);
     oversampleT->setLabel("Oversample");
     addAndMakeVisible(*oversampleT);
+    oversampleD->onGuiSetValue = [this]() { editor.resetEnablement(); };
+    editor.componentRefreshByID[rn.oversample.meta.id] = [this]() { editor.resetEnablement(); };
+
+    createComponent(editor, *this, rn.oversamplePhase, oversamplePhaseT, oversamplePhaseD);
+    oversamplePhaseT->setDrawMode(sst::jucegui::components::ToggleButton::DrawMode::LABELED);
+    oversamplePhaseT->setLabel("Lin Phase");
+    addAndMakeVisible(*oversamplePhaseT);
+
+    // Key Track is left to the host, as the knob column is full
+    createComponent(editor, *this, rn.polyphony, polyphonyT, polyphonyD);
+    polyphonyT->setDrawMode(sst::jucegui::components::ToggleButton::DrawMode::LABELED);
+    polyphonyT->setLabel("Poly");
+    addAndMakeVisible(*polyphonyT);
 
     enableFB();
 
@@ -85,6 +103,8 @@ RoutingPanel::RoutingPanel(PluginEditor &ed)
     auto bi = 300;
     jcad::setTraversalId(routingModeS.get(), bi++);
     jcad::setTraversalId(oversampleT.get(), bi++);
+    jcad::setTraversalId(oversamplePhaseT.get(), bi++);
+    jcad::setTraversalId(polyphonyT.get(), bi++);
     jcad::setTraversalId(retriggerModeS.get(), bi++);
     jcad::setTraversalId(igK.get(), bi++);
     jcad::setTraversalId(ogK.get(), bi++);
@@ -93,6 +113,7 @@ RoutingPanel::RoutingPanel(PluginEditor &ed)
     jcad::setTraversalId(mixK.get(), bi++);
     jcad::setTraversalId(fbPowerT.get(), bi++);
     jcad::setTraversalId(feedbackK.get(), bi++);
+    jcad::setTraversalId(feedbackEcoT.get(), bi++);
     jcad::setTraversalId(noisePowerT.get(), bi++);
     jcad::setTraversalId(noiseLevelK.get(), bi++);
 }
@@ -103,9 +124,13 @@ void RoutingPanel::resized()
     routingModeS->setBounds(ca.withHeight(70));
     ca = ca.withTrimmedTop(73);
 
-    oversampleT->setBounds(ca.withHeight(20));
+    auto osr = ca.withHeight(20);
+    oversampleT->setBounds(osr.withTrimmedRight(osr.getWidth() * 0.45 + 1));
+    oversamplePhaseT->setBounds(osr.withTrimmedLeft(osr.getWidth() * 0.55 + 1));
 
-    retriggerModeL->setBounds(ca.withHeight(18).translated(0, 22));
+    auto rtr = ca.withHeight(18).translated(0, 22);
+    retriggerModeL->setBounds(rtr.withTrimmedRight(rtr.getWidth() * 0.45 + 1));
+    polyphonyT->setBounds(rtr.withTrimmedLeft(rtr.getWidth() * 0.55 + 1));
     retriggerModeS->setBounds(ca.withHeight(20).translated(0, 42));
 
     ca = ca.withTrimmedTop(76);
@@ -122,6 +147,7 @@ void RoutingPanel::resized()
 
     auto tr = feedbackK->getBounds().withHeight(15).translated(-10, -4);
     fbPowerT->setBounds(tr);
+    feedbackEcoT->setBounds(tr.withTrimmedLeft(tr.getWidth() - 28).translated(20, 0));
     auto nr = noiseLevelK->getBounds().withWidth(15).withHeight(15).translated(-10, -4);
     noisePowerT->setBounds(nr);
 }
@@ -130,10 +156,15 @@ void RoutingPanel::enableFB()
 {
     feedbackK->setEnabled(editor.patchMainRef.routingNode.feedbackPower.value > 0.5f);
     feedbackK->repaint();
+    feedbackEcoT->setEnabled(editor.patchMainRef.routingNode.feedbackPower.value > 0.5f);
+    feedbackEcoT->repaint();
 
     noiseLevelK->setEnabled(editor.patchMainRef.routingNode.noisePower.value > 0.5f);
     noiseLevelK->repaint();
 
+    oversamplePhaseT->setEnabled(editor.patchMainRef.routingNode.oversample.value > 0.5f);
+    oversamplePhaseT->repaint();
+
     auto m = (int)editor.patchMainRef.routingNode.routingMode;
     filterBlendSerialK->setVisible(m == 0);
     filterBlendParallelK->setVisible(m != 0);
@@ -172,7 +203,7 @@ void RoutingPanel::randomize()
     wri(rn.feedbackPower, fbPowerD, fbPowerT);
     wri(rn.noisePower, noisePowerD, noisePowerT);
 
-    // purposefully skip oversample
+    // purposefully skip oversample and its phase, eco feedback and poly
 
     enableFB();
     repaint();
@@ -33,7 +33,8 @@ struct RoutingPanel : sst::jucegui::components::NamedPanel
 
     PluginEditor &editor;
 
-    std::unique_ptr<PatchDiscrete> routingModeD, fbPowerD, noisePowerD, retriggerModeD, oversampleD;
+    std::unique_ptr<PatchDiscrete> routingModeD, fbPowerD, noisePowerD, retriggerModeD, oversampleD,
+        oversamplePhaseD, feedbackEcoD, polyphonyD;
     std::unique_ptr<PatchContinuous> feedbackD, mixD, igD, ogD, noiseLevelD, filterBlendSerialD,
         filterBlendParallelD;
 
@@ -42,7 +43,8 @@ struct RoutingPanel : sst::jucegui::components::NamedPanel
     std::unique_ptr<sst::jucegui::components::MultiSwitch> routingModeS;
     std::unique_ptr<sst::jucegui::components::JogUpDownButton> retriggerModeS;
     std::unique_ptr<sst::jucegui::components::Label> retriggerModeL;
-    std::unique_ptr<sst::jucegui::components::ToggleButton> fbPowerT, noisePowerT, oversampleT;
+    std::unique_ptr<sst::jucegui::components::ToggleButton> fbPowerT, noisePowerT, oversampleT,
+        oversamplePhaseT, feedbackEcoT, polyphonyT;
 
     void enableFB();
 
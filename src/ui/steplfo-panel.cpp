@@ -16,21 +16,27 @@
 #include "steplfo-panel.h"
 #include "sst/jucegui/components/VSlider.h"
 #include "sst/jucegui/components/BaseStyles.h"
+#include "engine/steplfo_songpos.h"
+#include "engine/trace-recorder.h"
 
 namespace baconpaul::twofilters::ui
 {
 
 struct StepEditor : juce::Component
 {
-    StepEditor(StepLFOPanel &p) : panel(p), lfo(tp)
+    StepEditor(StepLFOPanel &p) : panel(p), lfo(Engine::sharedTuningProvider())
     {
-        tp.init();
         for (int i = 0; i < maxSteps; i++)
-            panel.editor.componentRefreshByID[panel.stepDs[i]->pid] = [this]() { repaint(); };
+            panel.editor.componentRefreshByID[panel.stepDs[i]->pid] = [this, i]()
+            {
+                invalidateStep(i);
+                repaint();
+            };
     }
 
     void paint(juce::Graphics &g) override
     {
+        TF_TRACE_SCOPE("ui", "StepEditor::paint");
         float bw = getWidth() * 1.0 / maxSteps;
         namespace bst = sst::jucegui::components::base_styles;
         auto gCol =
@@ -96,7 +102,7 @@ struct StepEditor : juce::Component
                            juce::Justification::centredBottom, false);
             }
         }
-        if (panel.editor.cpuGraphicsMode != PluginEditor::MINIMAL)
+        if (panel.editor.graphicsMode() != PluginEditor::MINIMAL)
         {
             auto cs = panel.currentStep;
             if (cs >= 0 && cs < maxSteps)
@@ -106,7 +112,7 @@ struct StepEditor : juce::Component
             }
         }
 
-        if (panel.editor.cpuGraphicsMode == PluginEditor::FULL)
+        if (panel.editor.graphicsMode() == PluginEditor::FULL)
         {
             auto cs = panel.currentStep;
             auto xC = (cs + panel.currentPhase) * bw;
@@ -130,10 +136,37 @@ struct StepEditor : juce::Component
     Engine::stepLfo_t lfo;
     Engine::stepLfo_t::Storage lfoStorage;
     sst::basic_blocks::dsp::RNG rng;
-    sst::basic_blocks::tables::EqualTuningProvider tp;
     sst::basic_blocks::modulators::Transport transport;
+
+    /*
+     * The preview is kept as one run of points per step, each found by placing the LFO
+     * directly at (step, phase) rather than running it from the start. The smoothed shape
+     * of a step only depends on its near neighbours, so editing one step refreshes just the
+     * segments around it; the path itself is cheap to rebuild from the cached points.
+     */
+    static constexpr int pointsPerStep{48};
+    std::array<std::array<float, pointsPerStep>, maxSteps> segmentPoints{};
+    std::array<bool, maxSteps> segmentValid{};
     bool pathValid{false};
-    void invalidatePath() { pathValid = false; }
+
+    void invalidatePath()
+    {
+        segmentValid.fill(false);
+        pathValid = false;
+    }
+    void resized() override { pathValid = false; }
+    void invalidateStep(int step)
+    {
+        auto steps = (int)panel.editor.patchMainRef.stepLfoNodes[panel.instance].stepCount;
+        if (steps <= 0 || step >= steps)
+            return;
+
+        // Smoothing interpolates across the steps either side (wrapping at the step count),
+        // so a step shapes the two segments leading in and the one after it.
+        for (int d = -2; d <= 1; ++d)
+            segmentValid[(step + d + steps) % steps] = false;
+        pathValid = false;
+    }
     void rebuildLfoPath()
     {
         if (pathValid)
@@ -142,31 +175,42 @@ struct StepEditor : juce::Component
         transport.tempo = 120;
         auto rate = 7;
         auto sr = 48000;
-        auto steps = panel.editor.patchMainRef.stepLfoNodes[panel.instance].stepCount;
+        auto steps = (int)panel.editor.patchMainRef.stepLfoNodes[panel.instance].stepCount;
 
-        rng.reseed(8675309);
-        lfo.setSampleRate(sr, 1.0 / sr);
-        Engine::updateLfoStorageFromTo(panel.editor.patchMainRef, panel.instance, lfoStorage);
-        lfo.assign(&lfoStorage, rate, &transport, rng, true);
+        bool anyStale{false};
+        for (int s = 0; s < steps; ++s)
+            anyStale = anyStale || !segmentValid[s];
 
-        auto stepTime = 1.0 / (1 << 7);
-        auto stepSamples = sr * stepTime;
-        auto stepBlocks = stepSamples / blockSize;
+        if (anyStale)
+        {
+            rng.reseed(8675309);
+            lfo.setSampleRate(sr, 1.0 / sr);
+            Engine::updateLfoStorageFromTo(panel.editor.patchMainRef, panel.instance, lfoStorage);
+            lfo.assign(&lfoStorage, rate, &transport, rng, true);
+
+            for (int s = 0; s < steps; ++s)
+            {
+                if (segmentValid[s])
+                    continue;
+                for (int p = 0; p < pointsPerStep; ++p)
+                    segmentPoints[s][p] = stepLFOValueAt(lfo, rate, s, 1.f * p / pointsPerStep);
+                segmentValid[s] = true;
+            }
+        }
 
         lfoPath.clear();
 
-        auto tx = [=, this](auto x) { return x / (stepBlocks * 16) * getWidth(); };
-        auto ty = [=, this](auto y) { return (1 - (y + 1) / 2.) * getHeight(); };
-        for (int i = 0; i < steps * stepBlocks; ++i)
+        auto tx = [this](auto s, auto p)
+        { return (s + 1.f * p / pointsPerStep) / maxSteps * getWidth(); };
+        auto ty = [this](auto y) { return (1 - (y + 1) / 2.) * getHeight(); };
+        for (int s = 0; s < steps; ++s)
         {
-            lfo.process(rate, 0, true, false, blockSize);
-            if (i == 0)
-            {
-                lfoPath.startNewSubPath(tx(i), ty(lfo.output));
-            }
-            else
+            for (int p = 0; p < pointsPerStep; ++p)
             {
-                lfoPath.lineTo(tx(i), ty(lfo.output));
+                if (s == 0 && p == 0)
+                    lfoPath.startNewSubPath(tx(s, p), ty(segmentPoints[s][p]));
+                else
+                    lfoPath.lineTo(tx(s, p), ty(segmentPoints[s][p]));
             }
         }
 
@@ -296,9 +340,9 @@ StepLFOPanel::StepLFOPanel(PluginEditor &editor, int instance)
     for (int i = 0; i < maxSteps; i++)
     {
         stepDs[i] = std::make_unique<PatchContinuous>(editor, sn.steps[i].meta.id);
-        stepDs[i]->onGuiSetValue = [this]()
+        stepDs[i]->onGuiSetValue = [this, i]()
         {
-            stepEditor->invalidatePath();
+            stepEditor->invalidateStep(i);
             stepEditor->repaint();
         };
     }
@@ -482,7 +526,7 @@ void StepLFOPanel::onModelChanged()
 
 void StepLFOPanel::setCurrentStep(int cs)
 {
-    if (editor.cpuGraphicsMode != PluginEditor::MINIMAL)
+    if (editor.graphicsMode() != PluginEditor::MINIMAL)
     {
         if (cs != currentStep)
         {
@@ -494,7 +538,7 @@ void StepLFOPanel::setCurrentStep(int cs)
 
 void StepLFOPanel::setCurrentPhase(float ph)
 {
-    if (editor.cpuGraphicsMode == PluginEditor::FULL)
+    if (editor.graphicsMode() == PluginEditor::FULL)
     {
         currentPhase = ph;
         stepEditor->repaint();
@@ -503,7 +547,7 @@ void StepLFOPanel::setCurrentPhase(float ph)
 
 void StepLFOPanel::setCurrentLevel(float ph)
 {
-    if (editor.cpuGraphicsMode == PluginEditor::FULL)
+    if (editor.graphicsMode() == PluginEditor::FULL)
     {
         currentLevel = ph;
         stepEditor->repaint();
@@ -28,6 +28,7 @@ enum Defaults
     useSoftwareRenderer, // only used on windows
     useLowCpuGraphics,
     modelConfigMode,
+    presetTransitionMs,
     numDefaults
 };
 
@@ -45,6 +46,8 @@ inline std::string defaultName(Defaults d)
         return "useLowCpuGraphics";
     case modelConfigMode:
         return "modelConfigMode";
+    case presetTransitionMs:
+        return "presetTransitionMs";
     case numDefaults:
     {
         SQLOG("Software Error - defaults found");
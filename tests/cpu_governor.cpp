@@ -0,0 +1,186 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine/engine.h"
+
+using namespace baconpaul::twofilters;
+
+namespace
+{
+constexpr double sr{48000};
+constexpr uint32_t frames{256};
+constexpr uint32_t callsPerWindow{(uint32_t)(sr * CpuGovernor::windowSeconds) / frames + 1};
+
+// Calls until the target changes, or max
+uint32_t callsToChange(CpuGovernor &g, float load, uint32_t max = 10000)
+{
+    for (uint32_t c = 1; c <= max; ++c)
+        if (g.record(load * frames / sr, frames))
+            return c;
+    return max + 1;
+}
+} // namespace
+
+TEST_CASE("The CPU governor steps down under load and back up with headroom", "[governor]")
+{
+    CpuGovernor g;
+    g.setSampleRate(sr);
+
+    // A passing spike does nothing
+    for (uint32_t c = 0; c < callsPerWindow; ++c)
+        g.record(0.95 * frames / sr, frames);
+    for (uint32_t c = 0; c < callsPerWindow * 4; ++c)
+        REQUIRE(!g.record(0.5 * frames / sr, frames));
+    REQUIRE(g.target == CpuGovernor::Full);
+
+    for (uint32_t l = CpuGovernor::NoOversampling; l < CpuGovernor::numLevels; ++l)
+    {
+        REQUIRE(callsToChange(g, 0.9f) <= callsPerWindow * CpuGovernor::windowsToStepDown);
+        REQUIRE(g.target == l);
+    }
+    REQUIRE(callsToChange(g, 0.9f, callsPerWindow * 10) > callsPerWindow * 10);
+    REQUIRE(g.target == CpuGovernor::LowTelemetry);
+
+    auto upCalls = callsToChange(g, 0.1f);
+    REQUIRE(upCalls > callsPerWindow * (CpuGovernor::windowsToStepUp - 1));
+    REQUIRE(upCalls <= callsPerWindow * CpuGovernor::windowsToStepUp);
+    REQUIRE(g.target == CpuGovernor::CoarseControl);
+
+    SECTION("An overload straight after a step up backs the next one off")
+    {
+        REQUIRE(callsToChange(g, 0.9f) <= callsPerWindow * CpuGovernor::windowsToStepDown);
+        REQUIRE(g.target == CpuGovernor::LowTelemetry);
+        auto backedOff = callsToChange(g, 0.1f);
+        REQUIRE(backedOff > callsPerWindow * (2 * CpuGovernor::windowsToStepUp - 1));
+        REQUIRE(g.target == CpuGovernor::CoarseControl);
+    }
+    SECTION("Headroom walks back to full")
+    {
+        while (g.target != CpuGovernor::Full)
+            REQUIRE(callsToChange(g, 0.1f) <= callsPerWindow * CpuGovernor::windowsToStepUp);
+    }
+}
+
+TEST_CASE("The CPU governor output stage pads and fades", "[governor]")
+{
+    CpuGovernor g;
+    g.setSampleRate(sr);
+    REQUIRE(g.outputIdle());
+
+    constexpr uint32_t pad{31}, n{1024};
+    g.setPad(pad);
+    std::vector<float> L(n), R(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        L[i] = (float)i;
+        R[i] = -(float)i;
+    }
+    g.processOutput(L.data(), R.data(), n);
+    for (uint32_t i = pad; i < n; ++i)
+    {
+        REQUIRE(L[i] == (float)(i - pad));
+        REQUIRE(R[i] == -(float)(i - pad));
+    }
+
+    g.setPad(0);
+    g.gainTarget = 0;
+    std::fill(L.begin(), L.end(), 1.f);
+    std::fill(R.begin(), R.end(), 1.f);
+    g.processOutput(L.data(), R.data(), n);
+    auto fadeSamples = (uint32_t)std::ceil(sr * CpuGovernor::fadeSeconds);
+    for (uint32_t i = 1; i < n; ++i)
+        REQUIRE(L[i] <= L[i - 1]);
+    REQUIRE(L[0] > 0.9f);
+    REQUIRE(L[fadeSamples + 1] == 0.f);
+    REQUIRE(g.gain == 0.f);
+}
+
+TEST_CASE("The engine steps through the governor levels without a break", "[governor]")
+{
+    using RM = Engine::RoutingModes;
+    auto e = std::make_unique<Engine>();
+    auto &rn = e->patch.routingNode;
+    rn.routingMode = (float)(int)RM::Serial;
+    rn.oversample = 1.f;
+    rn.cpuGovernor = 1.f;
+    rn.mix = 0.5f;
+    e->patch.filterNodes[0].resonance = 0.7f;
+    e->overSampling = true;
+    e->setSampleRate(sr);
+    e->reportedLatency = Engine::latencyFor(e->patch);
+
+    // The plugin's loop, with each buffer reported as taking `load` of its time
+    size_t sample{0};
+    uint32_t blockPos{0};
+    float prevL{0};
+    auto run = [&](float load, uint32_t buffers)
+    {
+        std::vector<float> outL(frames), outR(frames);
+        for (uint32_t b = 0; b < buffers; ++b)
+        {
+            for (uint32_t s = 0; s < frames; ++s, ++sample)
+            {
+                if (blockPos == 0)
+                    e->processControl(nullptr);
+                float in = 0.4f * std::sin(sample * 0.01f);
+                if (e->overSampling)
+                    e->processAudio<RM::Serial, false, false, true>(in, in, outL[s], outR[s]);
+                else
+                    e->processAudio<RM::Serial, false, false, false>(in, in, outL[s], outR[s]);
+                blockPos = (blockPos + 1) & (e->controlBlockSize - 1);
+            }
+            e->governorEndProcess(outL.data(), outR.data(), frames, load * frames / sr);
+
+            for (uint32_t s = 0; s < frames; ++s)
+            {
+                INFO("sample " << sample - frames + s);
+                REQUIRE(std::isfinite(outL[s]));
+                // Nothing jumps by more than the signal can in a sample
+                REQUIRE(std::abs(outL[s] - prevL) < 0.1f);
+                prevL = outL[s];
+            }
+        }
+    };
+
+    auto windowBuffers = callsPerWindow;
+    run(0.1f, windowBuffers * 2);
+    REQUIRE(e->appliedGovernorLevel == CpuGovernor::Full);
+    REQUIRE(e->overSampling);
+
+    run(0.9f, windowBuffers * (CpuGovernor::windowsToStepDown + 1));
+    REQUIRE(e->appliedGovernorLevel == CpuGovernor::NoOversampling);
+    REQUIRE(!e->overSampling);
+    REQUIRE(e->cpuGovernor.padSamples == e->reportedLatency);
+
+    run(0.9f, windowBuffers * (CpuGovernor::windowsToStepDown * 2 + 1));
+    REQUIRE(e->appliedGovernorLevel == CpuGovernor::LowTelemetry);
+    REQUIRE(e->coarseControl);
+    REQUIRE(e->controlBlockSize == 2 * blockSize);
+
+    // Turning the governor off goes straight back to full quality
+    rn.cpuGovernor = 0.f;
+    run(0.9f, windowBuffers);
+    REQUIRE(e->appliedGovernorLevel == CpuGovernor::Full);
+    REQUIRE(e->overSampling);
+    REQUIRE(!e->coarseControl);
+    REQUIRE(e->controlBlockSize == blockSize);
+    REQUIRE(e->cpuGovernor.outputIdle());
+}
@@ -17,8 +17,15 @@
 
 #include <cmath>
 #include <algorithm>
+#include <initializer_list>
+#include <vector>
 
+#include "engine_fixture.h"
+#include "engine/engine-core.h"
 #include "engine/steplfo_songpos.h"
+#include "engine/linear-phase-halfband.h"
+#include "engine/block-noise.h"
+#include "engine/dsp-kernels.h"
 #include "sst/basic-blocks/modulators/StepLFO.h"
 #include "sst/basic-blocks/modulators/Transport.h"
 #include "sst/basic-blocks/tables/EqualTuningProvider.h"
@@ -158,3 +165,193 @@ TEST_CASE("stepLFOSongPos matches a free-running StepLFO", "[lfo]")
         REQUIRE(d < 1e-3);
     }
 }
+
+TEST_CASE("A step LFO placed at a phase matches one running to it", "[lfo]")
+{
+    // The step editor caches its preview segment by segment from stepLFOValueAt, so each
+    // point has to be where a free running LFO would be at that step and phase
+    namespace mod = sst::basic_blocks::modulators;
+    constexpr size_t bs = 8;
+
+    sst::basic_blocks::tables::EqualTuningProvider tp;
+    tp.init();
+    sst::basic_blocks::dsp::RNG rngA, rngB;
+
+    for (auto smooth : {0.f, 0.4f})
+    {
+        INFO("smooth " << smooth);
+        mod::StepLFO<bs>::Storage storage;
+        for (int i = 0; i < (int)storage.data.size(); ++i)
+            storage.data[i] = std::sin(i * 0.7f);
+        storage.repeat = 8;
+        storage.smooth = smooth;
+        storage.rateIsForSingleStep = true;
+
+        mod::Transport transport;
+        transport.tempo = 120.0;
+        const double sr = 48000.0;
+        const float rate = 7.f;
+
+        mod::StepLFO<bs> running(tp), placed(tp);
+        for (auto *l : {&running, &placed})
+        {
+            l->setSampleRate(sr, 1.0 / sr);
+            l->assign(&storage, rate, &transport, l == &running ? rngA : rngB, true);
+            l->retrigger();
+        }
+
+        for (int blk = 0; blk < 2000; ++blk)
+        {
+            running.process(rate, 0, true, false, bs);
+            auto v = stepLFOValueAt(placed, rate, running.getCurrentStep(), running.phase);
+            INFO("blk " << blk << " step " << running.getCurrentStep() << " phase "
+                        << running.phase);
+            REQUIRE(v == Approx(running.output).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("Linear phase oversampling delays by exactly its latency", "[oversampling]")
+{
+    // An up / down pair should be a pure delay of `latency` samples below the transition band
+    using hb_t = baconpaul::twofilters::LinearPhaseHalfBand;
+    hb_t up, dn;
+    const double w = 2.0 * M_PI * 0.05;
+    for (int n = 0; n < 2000; ++n)
+    {
+        float inL = std::sin(w * n), inR = std::cos(w * n);
+        float uL[2], uR[2], oL, oR;
+        up.process_sample_U2(inL, inR, uL, uR);
+        dn.process_sample_D2(uL, uR, oL, oR);
+        if (n > 4 * hb_t::latency)
+        {
+            INFO("sample " << n);
+            REQUIRE(oL == Approx(std::sin(w * (n - hb_t::latency))).margin(1e-4));
+            REQUIRE(oR == Approx(std::cos(w * (n - hb_t::latency))).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("Block noise matches the per sample noise statistics", "[noise]")
+{
+    // Uniform on [-1, 1) like RNG::unifPM1: mean 0, variance 1/3, and no correlation from
+    // one value to the next or between the channels
+    baconpaul::twofilters::BlockNoise noise;
+    noise.seed(8675309);
+
+    double sum{0}, sumSq{0}, lag{0}, cross{0};
+    float prev{0};
+    int n{0};
+    for (int b = 0; b < 20000; ++b)
+    {
+        noise.fill(baconpaul::twofilters::BlockNoise::maxSamples);
+        for (uint32_t i = 0; i < baconpaul::twofilters::BlockNoise::maxSamples; ++i)
+        {
+            auto l = noise.values[0][i], r = noise.values[1][i];
+            REQUIRE(l >= -1.f);
+            REQUIRE(l < 1.f);
+            sum += l;
+            sumSq += l * l;
+            lag += l * prev;
+            cross += l * r;
+            prev = l;
+            n++;
+        }
+    }
+    REQUIRE(sum / n == Approx(0).margin(0.01));
+    REQUIRE(sumSq / n == Approx(1.0 / 3).margin(0.01));
+    REQUIRE(lag / n == Approx(0).margin(0.01));
+    REQUIRE(cross / n == Approx(0).margin(0.01));
+}
+
+TEST_CASE("Every CPU level of the DSP kernels agrees with the baseline", "[dispatch]")
+{
+    using dk_t = baconpaul::twofilters::DspKernels;
+    using bn_t = baconpaul::twofilters::BlockNoise;
+    auto *base = dk_t::forLevel(dk_t::Level::Baseline);
+    REQUIRE(base);
+
+    float a[64], b[64];
+    for (int i = 0; i < 64; ++i)
+    {
+        a[i] = std::sin(i * 0.3f);
+        b[i] = std::cos(i * 0.7f);
+    }
+    // Straddle the low word of the counter, so the carry is covered too
+    const uint64_t counter{0xFFFFFFF0ULL};
+    float b0[16], b1[16];
+    base->noiseUniform(17, counter, 16, b0, b1);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        REQUIRE(b0[i] == bn_t::toPM1(bn_t::hash(17, counter + 2 * i)));
+        REQUIRE(b1[i] == bn_t::toPM1(bn_t::hash(17, counter + 2 * i + 1)));
+    }
+
+    for (auto l : {dk_t::Level::AVX2, dk_t::Level::AVX512})
+    {
+        auto *k = dk_t::forLevel(l);
+        if (!k)
+            continue;
+        INFO(k->name);
+        REQUIRE(k->dot(a, b, 64) == base->dot(a, b, 64));
+
+        float o0[16], o1[16];
+        k->noiseUniform(17, counter, 16, o0, o1);
+        for (int i = 0; i < 16; ++i)
+        {
+            REQUIRE(o0[i] == b0[i]);
+            REQUIRE(o1[i] == b1[i]);
+        }
+    }
+}
+
+TEST_CASE("Every CPU level of the DSP core renders the same bits", "[dispatch]")
+{
+    using dk_t = DspKernels;
+    using RM = Engine::RoutingModes;
+    // The level is picked once, with the first engine; each render here swaps it in itself
+    auto first = std::make_unique<Engine>();
+    auto *selected = activeDspKernels;
+
+    auto renderWith = [](const DspKernels *k, bool linear)
+    {
+        activeDspKernels = k;
+        auto e = test::makeEngine(RM::Serial, true, true,
+                                  [linear](Patch &p)
+                                  {
+                                      p.routingNode.feedback = 0.5f;
+                                      p.routingNode.oversamplePhase = linear ? 1.f : 0.f;
+                                      p.filterNodes[0].resonance = 0.7f;
+                                  });
+        auto render = engineCore().render[(int)RM::Serial][1][0][1];
+
+        std::vector<float> inL(blockSize), inR(blockSize), oL(blockSize), oR(blockSize), res;
+        for (size_t b = 0; b < 200; ++b)
+        {
+            for (size_t i = 0; i < blockSize; ++i)
+            {
+                inL[i] = test::input(b * blockSize + i, 0);
+                inR[i] = test::input(b * blockSize + i, 1);
+            }
+            e->processControl(nullptr);
+            render(*e, inL.data(), inR.data(), oL.data(), oR.data(), blockSize);
+            res.insert(res.end(), oL.begin(), oL.end());
+            res.insert(res.end(), oR.begin(), oR.end());
+        }
+        return res;
+    };
+
+    for (auto linear : {false, true})
+    {
+        auto base = renderWith(dk_t::forLevel(dk_t::Level::Baseline), linear);
+        for (auto l : {dk_t::Level::AVX2, dk_t::Level::AVX512})
+        {
+            auto *k = dk_t::forLevel(l);
+            if (!k)
+                continue;
+            INFO(k->name << " running the " << k->core()->name << " core, linear " << linear);
+            REQUIRE(renderWith(k, linear) == base);
+        }
+    }
+    activeDspKernels = selected;
+}
@@ -0,0 +1,88 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <vector>
+
+#include "engine_fixture.h"
+
+using namespace baconpaul::twofilters;
+using namespace baconpaul::twofilters::test;
+
+namespace
+{
+// Full feedback through the eco path, into a resonant first filter and a band pass
+void shapePatch(Patch &p)
+{
+    p.routingNode.feedbackEco = 1.f;
+    p.routingNode.feedback = 0.6f;
+    p.filterNodes[0].resonance = 0.8f;
+    p.filterNodes[0].pan = -0.3f;
+    p.filterNodes[1].model = sst::filtersplusplus::FilterModel::CytomicSVF;
+    p.filterNodes[1].config.pt = sst::filtersplusplus::Passband::BP;
+}
+
+// The block path against the per sample path reading the same eco buffers. Every fifth
+// block goes through the per sample path on both, as a block split over two process calls
+// would, so the hand over is covered too.
+template <RM mode, bool os> void compare()
+{
+    auto perSample = makeEngine(mode, true, os, shapePatch);
+    auto block = makeEngine(mode, true, os, shapePatch);
+
+    constexpr size_t total{blockSize * 600};
+    std::vector<float> inL(total), inR(total);
+    for (size_t s = 0; s < total; ++s)
+    {
+        inL[s] = input(s, 0);
+        inR[s] = input(s, 1);
+    }
+
+    std::vector<float> aL(total), aR(total), bL(total), bR(total);
+    for (size_t s = 0; s < total; s += blockSize)
+    {
+        perSample->processControl(nullptr);
+        block->processControl(nullptr);
+        REQUIRE(block->ecoFeedback);
+
+        for (size_t i = s; i < s + blockSize; ++i)
+            perSample->processAudio<mode, true, false, os>(inL[i], inR[i], aL[i], aR[i]);
+
+        if ((s / blockSize) % 5 == 4)
+        {
+            for (size_t i = s; i < s + blockSize; ++i)
+                block->processAudio<mode, true, false, os>(inL[i], inR[i], bL[i], bR[i]);
+        }
+        else
+        {
+            block->processBlockEco<mode, false, os>(inL.data() + s, inR.data() + s,
+                                                    bL.data() + s, bR.data() + s);
+        }
+    }
+
+    requireSameRender(aL, bL, 1e-5f);
+    requireSameRender(aR, bR, 1e-5f);
+}
+} // namespace
+
+TEST_CASE("Eco feedback renders the same by block or by sample", "[eco]")
+{
+    SECTION("Serial") { compare<RM::Serial, false>(); }
+    SECTION("FBBoth") { compare<RM::Parallel_FBBoth, false>(); }
+    SECTION("FBOne, oversampled") { compare<RM::Parallel_FBOne, true>(); }
+    SECTION("FBEach") { compare<RM::Parallel_FBEach, false>(); }
+    SECTION("FBEach, oversampled") { compare<RM::Parallel_FBEach, true>(); }
+}
@@ -0,0 +1,78 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#ifndef BACONPAUL_TWOFILTERS_TESTS_ENGINE_FIXTURE_H
+#define BACONPAUL_TWOFILTERS_TESTS_ENGINE_FIXTURE_H
+
+#include "catch2/catch2.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine/engine.h"
+
+namespace baconpaul::twofilters::test
+{
+using RM = Engine::RoutingModes;
+
+constexpr double sampleRate{48000};
+
+/*
+ * An engine as the plugin would activate it: the routing, feedback and oversampling a test
+ * varies go on the patch, `shape` sets whatever else that test needs, and the engine follows
+ * the patch's oversampling, phase and polyphony before its sample rate is set.
+ */
+template <typename F>
+std::unique_ptr<Engine> makeEngine(RM mode, bool fb, bool os, F &&shape)
+{
+    auto e = std::make_unique<Engine>();
+    auto &rn = e->patch.routingNode;
+    rn.routingMode = (float)(int)mode;
+    rn.feedbackPower = fb ? 1.f : 0.f;
+    rn.oversample = os ? 1.f : 0.f;
+    shape(e->patch);
+
+    e->overSampling = os;
+    e->linearPhase = rn.oversamplePhase > 0.5;
+    if (rn.polyphony > 0.5)
+        e->setupPolyVoices();
+    e->setSampleRate(sampleRate);
+    return e;
+}
+
+// A stereo input with different content on each side and a little DC
+inline float input(size_t s, int ch)
+{
+    return 0.5f * std::sin(s * (ch ? 0.031f : 0.017f)) + 0.05f;
+}
+
+// Two renders agree to within tol at every value, and the first isn't silent
+inline void requireSameRender(const std::vector<float> &a, const std::vector<float> &b, float tol)
+{
+    REQUIRE(a.size() == b.size());
+
+    float maxAbs{0};
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        INFO("value " << i);
+        REQUIRE(std::abs(a[i] - b[i]) < tol);
+        maxAbs = std::max(maxAbs, std::abs(a[i]));
+    }
+    REQUIRE(maxAbs > 0.01f);
+}
+} // namespace baconpaul::twofilters::test
+#endif // BACONPAUL_TWOFILTERS_TESTS_ENGINE_FIXTURE_H
@@ -0,0 +1,70 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+// The generated factory bank must be exactly what fromState would have produced from the
+// .twofl it was built from, in the plugin's own param order.
+
+#include "catch2/catch2.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "engine/patch.h"
+#include "presets/factory-bank.h"
+#include "filesystem/import.h"
+
+using namespace baconpaul::twofilters;
+namespace fb = baconpaul::twofilters::presets::factory_bank;
+
+TEST_CASE("Factory bank param order matches Patch::params", "[factory-bank]")
+{
+    Patch p;
+    REQUIRE(fb::paramCount == p.params.size());
+    for (size_t i = 0; i < fb::paramCount; ++i)
+        REQUIRE(fb::paramIds[i] == p.params[i]->meta.id);
+}
+
+TEST_CASE("Factory bank matches parsing the source patches", "[factory-bank]")
+{
+    REQUIRE(fb::entryCount > 0);
+
+    auto root = fs::path(sst::plugininfra::VersionInformation::cmake_source_dir) / "resources" /
+                "factory_patches";
+    for (size_t e = 0; e < fb::entryCount; ++e)
+    {
+        const auto &ent = fb::entries[e];
+        INFO(ent.category << "/" << ent.fileName);
+
+        std::ifstream t(root / ent.category / ent.fileName);
+        REQUIRE(t.is_open());
+        std::stringstream buffer;
+        buffer << t.rdbuf();
+
+        Patch p;
+        REQUIRE(p.fromState(buffer.str()));
+
+        for (size_t i = 0; i < fb::paramCount; ++i)
+            REQUIRE(ent.values[i] == p.params[i]->value);
+        for (size_t f = 0; f < numFilters; ++f)
+        {
+            REQUIRE(ent.filters[f].model == (int32_t)p.filterNodes[f].model);
+            REQUIRE(ent.filters[f].pt == (int32_t)p.filterNodes[f].config.pt);
+            REQUIRE(ent.filters[f].st == (int32_t)p.filterNodes[f].config.st);
+            REQUIRE(ent.filters[f].dt == (int32_t)p.filterNodes[f].config.dt);
+            REQUIRE(ent.filters[f].mt == (int32_t)p.filterNodes[f].config.mt);
+        }
+    }
+}
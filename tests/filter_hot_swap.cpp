@@ -0,0 +1,163 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <cmath>
+#include <memory>
+
+#include "engine/engine.h"
+
+using namespace baconpaul::twofilters;
+namespace sfpp = sst::filtersplusplus;
+
+namespace
+{
+// What the editor does for a model menu pick: patchMain first, then prepare and send
+const FilterUnit *changeFilter(Engine &e, sfpp::Passband pt, bool prepare)
+{
+    auto &fn = e.patchMain.filterNodes[0];
+    fn.config.pt = pt;
+    if (prepare)
+        e.prepareStandbyFilter(0);
+
+    Engine::MainToAudioMsg fm{Engine::MainToAudioMsg::SET_FILTER_MODEL, 0};
+    fm.uintValues[0] = (uint32_t)fn.model;
+    fm.uintValues[1] = (uint32_t)fn.config.pt;
+    fm.uintValues[2] = (uint32_t)fn.config.st;
+    fm.uintValues[3] = (uint32_t)fn.config.dt;
+    fm.uintValues[4] = (uint32_t)fn.config.mt;
+    e.mainToAudio.push(fm);
+    return e.standbyFilter[0].load();
+}
+} // namespace
+
+TEST_CASE("A prepared model change crossfades in", "[hot-swap]")
+{
+    auto e = std::make_unique<Engine>();
+    e->setSampleRate(48000);
+    e->processControl(nullptr);
+
+    auto runBlock = [&]()
+    {
+        e->processControl(nullptr);
+        for (size_t s = 0; s < blockSize; ++s)
+        {
+            float oL, oR;
+            e->processAudio<Engine::RoutingModes::Serial, false, false, false>(0.3f, -0.2f, oL,
+                                                                               oR);
+            REQUIRE(std::isfinite(oL));
+            REQUIRE(std::isfinite(oR));
+        }
+    };
+    runBlock();
+    const auto liveBefore = e->liveSlot[0];
+
+    SECTION("Prepared on the main thread")
+    {
+        auto *prepared = changeFilter(*e, sfpp::Passband::HP, true);
+        REQUIRE(prepared);
+        runBlock();
+
+        REQUIRE(e->liveSlot[0] != liveBefore);
+        REQUIRE(e->filterSlots[e->liveSlot[0]][0].get() == prepared);
+        REQUIRE(e->standbyFilter[0].load() == nullptr);
+        REQUIRE(e->fadeActive[0]);
+        REQUIRE(e->fadeBlocks[0] == (int32_t)std::ceil(Engine::modelSwapSeconds * 48000 /
+                                                       e->controlBlockSize));
+
+        // The unit it displaced comes back for the main thread to free
+        REQUIRE(e->collectRetiredFilters() == 1);
+
+        for (int32_t i = 0; i < e->fadeBlocks[0]; ++i)
+        {
+            REQUIRE(e->fadeActive[0]);
+            runBlock();
+        }
+        REQUIRE_FALSE(e->fadeActive[0]);
+    }
+
+    SECTION("A second change mid-fade waits for the first to finish")
+    {
+        auto *first = changeFilter(*e, sfpp::Passband::HP, true);
+        runBlock();
+        REQUIRE(e->fadeActive[0]);
+        const auto liveFirst = e->liveSlot[0];
+        REQUIRE(e->filterSlots[liveFirst][0].get() == first);
+
+        auto *second = changeFilter(*e, sfpp::Passband::BP, true);
+        REQUIRE(second);
+        runBlock();
+        // The first fade runs on untouched and the change is held, its unit still on standby
+        REQUIRE(e->liveSlot[0] == liveFirst);
+        REQUIRE(e->patch.filterNodes[0].config.pt == sfpp::Passband::HP);
+        REQUIRE(e->queuedFilterModel[0].has_value());
+        REQUIRE(e->standbyFilter[0].load() == second);
+
+        while (e->fadeActive[0])
+            runBlock();
+        runBlock();
+        REQUIRE(e->liveSlot[0] != liveFirst);
+        REQUIRE(e->filterSlots[e->liveSlot[0]][0].get() == second);
+        REQUIRE(e->patch.filterNodes[0].config.pt == sfpp::Passband::BP);
+        REQUIRE_FALSE(e->queuedFilterModel[0].has_value());
+        REQUIRE(e->fadeActive[0]);
+        REQUIRE(e->fadeModel[0] == e->patch.filterNodes[0].model);
+        REQUIRE(e->fadeConfig[0].pt == sfpp::Passband::HP);
+    }
+
+    SECTION("Nothing prepared still resets in place")
+    {
+        changeFilter(*e, sfpp::Passband::HP, false);
+        runBlock();
+        REQUIRE(e->liveSlot[0] == liveBefore);
+        REQUIRE_FALSE(e->fadeActive[0]);
+        REQUIRE(e->collectRetiredFilters() == 0);
+    }
+
+    SECTION("A unit prepared for an older setup is sent back unused")
+    {
+        auto *prepared = changeFilter(*e, sfpp::Passband::HP, true);
+        REQUIRE(prepared);
+        e->setSampleRate(96000);
+        runBlock();
+
+        REQUIRE(e->liveSlot[0] == liveBefore);
+        REQUIRE(e->filterSlots[e->liveSlot[0]][0].get() != prepared);
+        REQUIRE_FALSE(e->fadeActive[0]);
+        REQUIRE(e->standbyFilter[0].load() == nullptr);
+        REQUIRE(e->collectRetiredFilters() == 1);
+    }
+}
+
+TEST_CASE("Retired units outlast a full ring", "[hot-swap]")
+{
+    auto e = std::make_unique<Engine>();
+    e->setSampleRate(48000);
+
+    // As if the main thread had stopped collecting for a while
+    constexpr uint32_t retired{20};
+    for (uint32_t i = 0; i < retired; ++i)
+        e->retireFilter(new FilterUnit());
+    REQUIRE(e->retireBacklog);
+
+    auto collected = e->collectRetiredFilters();
+    REQUIRE(collected < retired);
+
+    // The next control block hands the rest over
+    e->processControl(nullptr);
+    REQUIRE_FALSE(e->retireBacklog);
+    REQUIRE(collected + e->collectRetiredFilters() == retired);
+}
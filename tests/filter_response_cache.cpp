@@ -0,0 +1,112 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <fstream>
+#include <vector>
+
+#include "ui/filter-response-cache.h"
+
+using namespace baconpaul::twofilters;
+namespace sfpp = sst::filtersplusplus;
+
+namespace
+{
+ui::FilterResponseCache::Key keyFor(float co)
+{
+    float res{0.5f}, mo{0.f};
+    return ui::FilterResponseCache::quantise(sfpp::FilterModel::CytomicSVF, {}, co, res, mo);
+}
+} // namespace
+
+TEST_CASE("Quantise snaps controls to the key", "[filter-cache]")
+{
+    float co{3.01f}, res{0.3333f}, mo{0.7071f};
+    auto k = ui::FilterResponseCache::quantise(sfpp::FilterModel::CytomicSVF, {}, co, res, mo);
+
+    float co2{co}, res2{res}, mo2{mo};
+    auto k2 = ui::FilterResponseCache::quantise(sfpp::FilterModel::CytomicSVF, {}, co2, res2, mo2);
+    REQUIRE(k == k2);
+    REQUIRE(co == co2);
+    REQUIRE(res == res2);
+    REQUIRE(mo == mo2);
+}
+
+TEST_CASE("Cache evicts least recently used entries", "[filter-cache]")
+{
+    ui::FilterResponseCache cache;
+    const size_t n = ui::FilterResponseCache::maxPoints / 4;
+    std::vector<float> x(n, 1.f), y(n, -3.f), ox, oy;
+
+    for (int i = 0; i < 4; ++i)
+        cache.insert(keyFor(i), x, y);
+
+    REQUIRE(cache.lookup(keyFor(0), ox, oy)); // touch 0 so 1 is now the oldest
+    cache.insert(keyFor(4), x, y);
+
+    REQUIRE(cache.lookup(keyFor(0), ox, oy));
+    REQUIRE_FALSE(cache.lookup(keyFor(1), ox, oy));
+    REQUIRE(cache.lookup(keyFor(4), ox, oy));
+    REQUIRE(oy == y);
+}
+
+TEST_CASE("Cache round trips through its file", "[filter-cache]")
+{
+    auto p = fs::temp_directory_path() / "two-filters-response-cache-test.bin";
+
+    ui::FilterResponseCache a;
+    a.insert(keyFor(12), {1.f, 2.f, 3.f}, {0.f, -6.f, -12.f});
+    a.save(p);
+
+    ui::FilterResponseCache b;
+    b.load(p);
+    std::vector<float> ox, oy;
+    REQUIRE(b.lookup(keyFor(12), ox, oy));
+    REQUIRE(ox == std::vector<float>{1.f, 2.f, 3.f});
+    REQUIRE(oy == std::vector<float>{0.f, -6.f, -12.f});
+
+    fs::remove(p);
+}
+
+TEST_CASE("A cache file with a bad count loads nothing", "[filter-cache]")
+{
+    auto p = fs::temp_directory_path() / "two-filters-response-cache-bad.bin";
+
+    ui::FilterResponseCache a;
+    a.insert(keyFor(12), {1.f, 2.f, 3.f}, {0.f, -6.f, -12.f});
+    a.save(p);
+    auto tmp = p;
+    tmp += ".tmp";
+    REQUIRE_FALSE(fs::exists(tmp));
+
+    // The count follows the magic, version, hash length and hash
+    {
+        std::fstream f(p, std::ios::binary | std::ios::in | std::ios::out);
+        uint32_t hashLen{0};
+        f.seekg(8);
+        f.read(reinterpret_cast<char *>(&hashLen), sizeof(hashLen));
+        uint32_t count{0xFFFFFFFF};
+        f.seekp(12 + hashLen);
+        f.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+
+    ui::FilterResponseCache b;
+    REQUIRE_NOTHROW(b.load(p));
+    std::vector<float> ox, oy;
+    REQUIRE_FALSE(b.lookup(keyFor(12), ox, oy));
+
+    fs::remove(p);
+}
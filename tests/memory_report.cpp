@@ -0,0 +1,48 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <memory>
+#include <set>
+
+#include "engine/engine.h"
+
+using namespace baconpaul::twofilters;
+
+TEST_CASE("Memory report covers the whole engine", "[memory]")
+{
+    auto engine = std::make_unique<Engine>();
+    auto r = engine->memoryReport();
+
+    std::set<std::string> names;
+    for (const auto &[n, b] : r.entries)
+    {
+        REQUIRE(names.insert(n).second);
+        // Whatever the named parts don't cover can come to nothing
+        if (n != "Other engine state")
+            REQUIRE(b > 0);
+    }
+
+    // Patches add their heap on top, so the total is at least the object itself
+    REQUIRE(r.total() >= sizeof(Engine));
+
+    // A patch and the metadata copied into its params are reported apart, and cover it
+    size_t audioPatch{0};
+    for (const auto &[n, b] : r.entries)
+        if (n == "Patch (audio)" || n == "Param metadata (audio)")
+            audioPatch += b;
+    REQUIRE(audioPatch > sizeof(Patch));
+}
@@ -0,0 +1,146 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "engine_fixture.h"
+
+using namespace baconpaul::twofilters;
+using namespace baconpaul::twofilters::test;
+
+namespace
+{
+// A resonant first filter into a band pass, with the oversampling phase under test
+auto shapePatch(bool linear)
+{
+    return [linear](Patch &p)
+    {
+        p.routingNode.feedback = 0.5f;
+        p.routingNode.oversamplePhase = linear ? 1.f : 0.f;
+        p.filterNodes[0].resonance = 0.7f;
+        p.filterNodes[1].model = sst::filtersplusplus::FilterModel::CytomicSVF;
+        p.filterNodes[1].config.pt = sst::filtersplusplus::Passband::BP;
+    };
+}
+
+// Mono, then a stretch where the right side differs, then mono again
+float monoThenStereo(size_t s, int ch)
+{
+    auto v = 0.4f * std::sin(s * 0.013f) + 0.2f * std::sin(s * 0.091f);
+    if (ch == 1 && s >= 3000 && s < 5000)
+        v += 0.1f * std::sin(s * 0.2f);
+    return v;
+}
+
+template <RM mode, bool fb, bool os> void compare(bool linear)
+{
+    auto stereo = makeEngine(mode, fb, os, shapePatch(linear));
+    auto mono = makeEngine(mode, fb, os, shapePatch(linear));
+
+    constexpr size_t total{9000};
+    std::vector<float> inL(total), inR(total);
+    for (size_t s = 0; s < total; ++s)
+    {
+        inL[s] = monoThenStereo(s, 0);
+        inR[s] = monoThenStereo(s, 1);
+    }
+
+    int monoBlocks{0};
+    for (size_t s = 0; s < total; ++s)
+    {
+        if (s % blockSize == 0)
+        {
+            stereo->processControl(nullptr);
+            mono->processControl(nullptr);
+            mono->chooseMonoBlock(inL.data() + s, inR.data() + s);
+            monoBlocks += mono->monoBlock;
+        }
+        float sL, sR, mL, mR;
+        stereo->processAudio<mode, fb, false, os>(inL[s], inR[s], sL, sR);
+        mono->processAudio<mode, fb, false, os>(inL[s], inR[s], mL, mR);
+
+        INFO("sample " << s);
+        REQUIRE(sL == mL);
+        REQUIRE(sR == mR);
+    }
+
+    // At least the first mono stretch, and never the stereo one
+    REQUIRE(monoBlocks > 2000 / (int)blockSize);
+    REQUIRE(monoBlocks < (int)((total - 2000) / blockSize));
+}
+} // namespace
+
+TEST_CASE("The mono path matches stereo processing exactly", "[mono]")
+{
+    SECTION("Serial with feedback") { compare<RM::Serial, true, false>(false); }
+    SECTION("FBBoth with feedback") { compare<RM::Parallel_FBBoth, true, false>(false); }
+    SECTION("FBEach with feedback, oversampled")
+    {
+        compare<RM::Parallel_FBEach, true, true>(false);
+    }
+    SECTION("FBOne, linear phase oversampled") { compare<RM::Parallel_FBOne, true, true>(true); }
+}
+
+TEST_CASE("A filter the blend hides keeps its stereo tail out of mono", "[mono]")
+{
+    // Only the second filter is heard at first, so the ringing first one can still differ
+    // side to side after the output has gone back to L == R
+    auto shape = [](Patch &p)
+    {
+        p.routingNode.filterBlendParallel = 1.f;
+        p.filterNodes[0].resonance = 0.95f;
+        p.filterNodes[1].model = sst::filtersplusplus::FilterModel::CytomicSVF;
+    };
+    auto stereo = makeEngine(RM::Parallel_FBOne, false, false, shape);
+    auto mono = makeEngine(RM::Parallel_FBOne, false, false, shape);
+
+    constexpr size_t total{9000}, showFirst{6000};
+    std::vector<float> inL(total), inR(total);
+    for (size_t s = 0; s < total; ++s)
+    {
+        inL[s] = monoThenStereo(s, 0);
+        inR[s] = monoThenStereo(s, 1);
+    }
+
+    int monoBlocks{0};
+    for (size_t s = 0; s < total; ++s)
+    {
+        if (s == showFirst)
+        {
+            stereo->patch.routingNode.filterBlendParallel = 0.f;
+            mono->patch.routingNode.filterBlendParallel = 0.f;
+        }
+        if (s % blockSize == 0)
+        {
+            stereo->processControl(nullptr);
+            mono->processControl(nullptr);
+            mono->chooseMonoBlock(inL.data() + s, inR.data() + s);
+            monoBlocks += mono->monoBlock;
+        }
+        float sL, sR, mL, mR;
+        stereo->processAudio<RM::Parallel_FBOne, false, false, false>(inL[s], inR[s], sL, sR);
+        mono->processAudio<RM::Parallel_FBOne, false, false, false>(inL[s], inR[s], mL, mR);
+
+        INFO("sample " << s);
+        REQUIRE(sL == mL);
+        REQUIRE(sR == mR);
+    }
+
+    // The mono stretch before the stereo one still runs mono
+    REQUIRE(monoBlocks > 0);
+}
@@ -0,0 +1,170 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine_fixture.h"
+
+using namespace baconpaul::twofilters;
+using namespace baconpaul::twofilters::test;
+
+namespace
+{
+// Serial with feedback and noise, so the bounce has state to carry between blocks
+std::unique_ptr<Engine> makeOfflineEngine(bool offlineQuality)
+{
+    return makeEngine(RM::Serial, true, false,
+                      [offlineQuality](Patch &p)
+                      {
+                          p.routingNode.feedback = 0.5f;
+                          p.routingNode.noisePower = 1.f;
+                          p.routingNode.noiseLevel = 0.3f;
+                          p.routingNode.offlineQuality = offlineQuality ? 1.f : 0.f;
+                          p.filterNodes[0].resonance = 0.7f;
+                      });
+}
+
+// The plugin's loop for one process call of `frames`, with a sine at `w` radians a sample
+std::vector<float> run(Engine &e, uint32_t &blockPos, uint32_t frames, float w)
+{
+    if (e.renderModeChanging())
+    {
+        blockPos = 0;
+        e.updateRenderSetup();
+    }
+
+    std::vector<float> out;
+    for (uint32_t s = 0; s < frames; ++s)
+    {
+        if (blockPos == 0)
+            e.processControl(nullptr);
+        float in = 0.4f * std::sin(s * w), L, R;
+        if (e.overSampling)
+            e.processAudio<RM::Serial, true, true, true>(in, in, L, R);
+        else
+            e.processAudio<RM::Serial, true, true, false>(in, in, L, R);
+        out.push_back(L);
+        out.push_back(R);
+        blockPos = (blockPos + 1) & (e.controlBlockSize - 1);
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("Offline renders run the quality profile and repeat exactly", "[offline]")
+{
+    auto e = makeOfflineEngine(true);
+    uint32_t blockPos{0};
+    constexpr uint32_t frames{4096};
+
+    run(*e, blockPos, 1000, 0.023f);
+    REQUIRE(!e->overSampling);
+    REQUIRE(e->controlBlockSize == blockSize);
+
+    auto render = [&]()
+    {
+        e->offlineRender = true;
+        e->transport.timeInBeats = 0; // the host starts each bounce at the same place
+        auto res = run(*e, blockPos, frames, 0.01f);
+        REQUIRE(e->renderBoost);
+        REQUIRE(e->overSampling);
+        REQUIRE(e->controlBlockSize == Engine::renderControlBlockSize);
+        REQUIRE(e->filterBlockSamples() == 2 * Engine::renderControlBlockSize);
+        return res;
+    };
+
+    auto first = render();
+    double energy{0};
+    for (auto v : first)
+    {
+        REQUIRE(std::isfinite(v));
+        energy += v * v;
+    }
+    REQUIRE(energy > 0);
+
+    // Realtime in between, on something else, with the patch's own settings back
+    e->offlineRender = false;
+    run(*e, blockPos, 3001, 0.037f);
+    REQUIRE(!e->renderBoost);
+    REQUIRE(!e->overSampling);
+    REQUIRE(e->controlBlockSize == blockSize);
+
+    auto second = render();
+    REQUIRE(second == first);
+}
+
+TEST_CASE("Offline renders are never governed, and keep the patch without the option",
+          "[offline]")
+{
+    auto e = makeOfflineEngine(false);
+    auto &rn = e->patch.routingNode;
+    rn.cpuGovernor = 1.f;
+    uint32_t blockPos{0};
+
+    run(*e, blockPos, 256, 0.01f);
+    REQUIRE(e->cpuGovernorOn);
+
+    e->offlineRender = true;
+    run(*e, blockPos, 256, 0.01f);
+    REQUIRE(!e->cpuGovernorOn);
+    REQUIRE(!e->renderBoost);
+    REQUIRE(!e->overSampling);
+    REQUIRE(e->controlBlockSize == blockSize);
+    REQUIRE(Engine::latencyFor(e->patch) == 0);
+
+    rn.offlineQuality = 1.f;
+    REQUIRE(Engine::latencyFor(e->patch) == Engine::iirOversamplingLatency());
+}
+
+TEST_CASE("A boosted render keeps the latency the host was told", "[offline]")
+{
+    auto e = makeOfflineEngine(true);
+    e->reportedLatency = Engine::latencyFor(e->patch);
+    REQUIRE(e->reportedLatency == Engine::iirOversamplingLatency());
+    uint32_t blockPos{0};
+
+    auto endProcess = [&](std::vector<float> &out)
+    {
+        std::vector<float> L, R;
+        for (size_t i = 0; i < out.size(); i += 2)
+        {
+            L.push_back(out[i]);
+            R.push_back(out[i + 1]);
+        }
+        e->governorEndProcess(L.data(), R.data(), (uint32_t)L.size(), 0);
+    };
+
+    // Realtime runs without oversampling, so the output is padded up to the render's delay
+    auto rt = run(*e, blockPos, 512, 0.01f);
+    endProcess(rt);
+    REQUIRE(e->runningLatency() == 0);
+    REQUIRE(e->cpuGovernor.padSamples == e->reportedLatency);
+
+    // The bounce oversamples and needs no pad
+    e->offlineRender = true;
+    auto off = run(*e, blockPos, 512, 0.01f);
+    endProcess(off);
+    REQUIRE(e->runningLatency() == e->reportedLatency);
+    REQUIRE(e->cpuGovernor.padSamples == 0);
+
+    e->offlineRender = false;
+    rt = run(*e, blockPos, 512, 0.01f);
+    endProcess(rt);
+    REQUIRE(e->cpuGovernor.padSamples == e->reportedLatency);
+}
@@ -0,0 +1,118 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "engine_fixture.h"
+
+using namespace baconpaul::twofilters;
+using namespace baconpaul::twofilters::test;
+
+namespace
+{
+// Both filters resonant and panned apart, the second a high pass
+void shapePatch(Patch &p)
+{
+    p.routingNode.feedback = 0.6f;
+    p.filterNodes[0].cutoff = 12.f;
+    p.filterNodes[0].resonance = 0.8f;
+    p.filterNodes[0].pan = -0.4f;
+    p.filterNodes[1].model = sst::filtersplusplus::FilterModel::CytomicSVF;
+    p.filterNodes[1].config.pt = sst::filtersplusplus::Passband::HP;
+    p.filterNodes[1].cutoff = -6.f;
+    p.filterNodes[1].pan = 0.7f;
+}
+
+// Irregular host buffers, so stretches start mid-block and some outgrow the render buffers
+const std::vector<uint32_t> bufferSizes{37, 8, 1, 500, 64, 3, 1030, 129};
+
+template <RM mode, bool fb, bool os> std::vector<float> runPerSample()
+{
+    auto e = makeEngine(mode, fb, os, shapePatch);
+    std::vector<float> res;
+    size_t s{0}, blockPos{0};
+    for (auto bs : bufferSizes)
+    {
+        for (uint32_t i = 0; i < bs; ++i, ++s)
+        {
+            if (blockPos == 0)
+                e->processControl(nullptr);
+            float oL, oR;
+            e->processAudio<mode, fb, false, os>(input(s, 0), input(s, 1), oL, oR);
+            res.push_back(oL);
+            res.push_back(oR);
+            blockPos = (blockPos + 1) & (blockSize - 1);
+        }
+    }
+    return res;
+}
+
+template <RM mode, bool fb, bool os> std::vector<float> runParallel()
+{
+    auto e = makeEngine(mode, fb, os, shapePatch);
+    // No host here, so the tasks run inline; the split is what is being checked.
+    e->parallelRender = std::make_unique<ParallelRender>();
+
+    std::vector<float> res;
+    size_t s{0}, blockPos{0};
+    for (auto bs : bufferSizes)
+    {
+        std::vector<float> oL(bs), oR(bs);
+        e->chooseMonoBlock(nullptr, nullptr);
+        e->beginParallel<mode, fb, os>(oL.data(), oR.data());
+        for (uint32_t i = 0; i < bs; ++i, ++s)
+        {
+            if (blockPos == 0)
+            {
+                e->processControl(nullptr);
+                e->planParallelBlock();
+            }
+            e->prepareParallelSample<false, os>(input(s, 0), input(s, 1));
+            blockPos = (blockPos + 1) & (blockSize - 1);
+        }
+        e->endParallel();
+        // Nothing rendered here is checked for L == R, so it can't open a mono block
+        REQUIRE_FALSE(e->stereoBlockSymmetric);
+        for (uint32_t i = 0; i < bs; ++i)
+        {
+            res.push_back(oL[i]);
+            res.push_back(oR[i]);
+        }
+    }
+    return res;
+}
+
+template <RM mode, bool fb, bool os> void compare()
+{
+    auto a = runPerSample<mode, fb, os>();
+    auto b = runParallel<mode, fb, os>();
+    requireSameRender(a, b, 1e-5f);
+}
+} // namespace
+
+TEST_CASE("Parallel render matches the per sample path", "[parallel]")
+{
+    SECTION("FBEach with feedback") { compare<RM::Parallel_FBEach, true, false>(); }
+    SECTION("FBEach with feedback, oversampled") { compare<RM::Parallel_FBEach, true, true>(); }
+    SECTION("FBOne with feedback") { compare<RM::Parallel_FBOne, true, false>(); }
+    SECTION("FBBoth without feedback") { compare<RM::Parallel_FBBoth, false, false>(); }
+    SECTION("FBBoth without feedback, oversampled")
+    {
+        compare<RM::Parallel_FBBoth, false, true>();
+    }
+}
@@ -111,6 +111,33 @@ TEST_CASE("copyValuesFrom copies values, filter config, name and dirty", "[patch
     }
 }
 
+TEST_CASE("Every Patch shares the same param order", "[patch-sync]")
+{
+    Patch a, b;
+    REQUIRE(a.params.size() == b.params.size());
+    for (size_t i = 0; i < a.params.size(); ++i)
+    {
+        REQUIRE(a.params[i]->meta.id == b.params[i]->meta.id);
+        REQUIRE(a.params[i]->meta.name == b.params[i]->meta.name);
+        REQUIRE(b.params[i] == b.paramMap.at(b.params[i]->meta.id));
+    }
+
+    // Each Patch's params are its own, not the prototype's it copied from
+    REQUIRE(b.paramMap.at(b.filterNodes[0].cutoff.meta.id) == &b.filterNodes[0].cutoff);
+    REQUIRE(b.paramMap.at(b.stepLfoNodes[1].steps[3].meta.id) == &b.stepLfoNodes[1].steps[3]);
+    a.filterNodes[0].cutoff = 7.f;
+    REQUIRE(b.filterNodes[0].cutoff.value != 7.f);
+
+    // and it is still the group-then-name order the ranks were taken from
+    for (size_t i = 1; i < b.params.size(); ++i)
+    {
+        const auto &prev = b.params[i - 1]->meta, &cur = b.params[i]->meta;
+        REQUIRE(prev.groupName <= cur.groupName);
+        if (prev.groupName == cur.groupName)
+            REQUIRE(prev.name < cur.name);
+    }
+}
+
 TEST_CASE("toState / fromState round-trips values and filter config", "[patch-sync]")
 {
     Patch a;
@@ -230,3 +257,63 @@ TEST_CASE("drainAudioToMainInto applies only patch-affecting messages", "[patch-
     // The queue is fully consumed (VU/LFO/sample-rate were discarded, not left behind).
     REQUIRE_FALSE(engine.audioToMain.pop().has_value());
 }
+
+TEST_CASE("Transition load crossfades a changed filter without stopping audio", "[patch-sync]")
+{
+    namespace sfpp = sst::filtersplusplus;
+    Engine engine;
+    auto out = makeOut();
+    engine.setSampleRate(48000);
+    engine.processControl(&out);
+
+    auto runBlock = [&]()
+    {
+        engine.processControl(&out);
+        for (size_t s = 0; s < blockSize; ++s)
+        {
+            float oL, oR;
+            engine.processAudio<Engine::RoutingModes::Serial, false, false, false>(
+                0.3f, -0.2f, oL, oR);
+            REQUIRE(std::isfinite(oL));
+            REQUIRE(std::isfinite(oR));
+        }
+    };
+
+    // Filter 1 goes from the default LP to HP; filter 2 stays at None.
+    // 1ms at 48k is six blocks
+    const int32_t blocks = 6;
+    Engine::MainToAudioMsg bt{Engine::MainToAudioMsg::BEGIN_TRANSITION_LOAD};
+    bt.uintValues[0] = 1;
+    engine.mainToAudio.push(bt);
+    for (uint32_t f = 0; f < numFilters; ++f)
+    {
+        auto model = engine.patch.filterNodes[f].model;
+        auto config = engine.patch.filterNodes[f].config;
+        if (f == 0)
+            config.pt = sfpp::Passband::HP;
+
+        Engine::MainToAudioMsg fm{Engine::MainToAudioMsg::SET_FILTER_MODEL, f};
+        fm.uintValues[0] = (uint32_t)model;
+        fm.uintValues[1] = (uint32_t)config.pt;
+        fm.uintValues[2] = (uint32_t)config.st;
+        fm.uintValues[3] = (uint32_t)config.dt;
+        fm.uintValues[4] = (uint32_t)config.mt;
+        engine.mainToAudio.push(fm);
+    }
+    engine.mainToAudio.push({Engine::MainToAudioMsg::END_TRANSITION_LOAD});
+
+    const auto liveBefore = engine.liveSlot[0];
+    runBlock();
+
+    REQUIRE(engine.audioRunning);
+    REQUIRE(engine.transitionBlocks == blocks);
+    REQUIRE(engine.liveSlot[0] != liveBefore);
+    REQUIRE(engine.fadeActive[0]);
+    REQUIRE_FALSE(engine.fadeActive[1]);
+
+    for (int i = 0; i < blocks - 1; ++i)
+        runBlock();
+    REQUIRE(engine.fadeActive[0]);
+    runBlock();
+    REQUIRE_FALSE(engine.fadeActive[0]);
+}
@@ -0,0 +1,175 @@
+/*
+ * Two Filters
+ *
+ * Two Filters, and some controls thereof
+ *
+ * Copyright 2024-2026, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/two-filters
+ */
+
+#include "catch2/catch2.hpp"
+
+#include <cmath>
+#include <memory>
+
+#include "engine_fixture.h"
+
+using namespace baconpaul::twofilters;
+using namespace baconpaul::twofilters::test;
+
+namespace
+{
+std::unique_ptr<Engine> makePolyEngine()
+{
+    auto e = makeEngine(RM::Serial, false, false,
+                        [](Patch &p)
+                        {
+                            p.routingNode.polyphony = 1.f;
+                            p.filterNodes[0].resonance = 0.6f;
+                        });
+    e->processControl(nullptr);
+    REQUIRE(e->polyMode);
+    return e;
+}
+
+// Runs n blocks of a steady input, returning the peak output
+float run(Engine &e, int blocks)
+{
+    float peak{0};
+    size_t s{0};
+    for (int b = 0; b < blocks; ++b)
+    {
+        e.processControl(nullptr);
+        for (size_t i = 0; i < blockSize; ++i, ++s)
+        {
+            float in = 0.5f * std::sin(s * 0.05f), oL, oR;
+            e.processPoly<RM::Serial, false, false, false>(in, in, oL, oR);
+            peak = std::max(peak, std::abs(oL));
+        }
+    }
+    return peak;
+}
+
+int activeVoices(const Engine &e)
+{
+    int res{0};
+    for (auto &v : e.poly->voices)
+        res += v.active;
+    return res;
+}
+} // namespace
+
+TEST_CASE("Poly voice allocation", "[poly]")
+{
+    auto e = makePolyEngine();
+
+    SECTION("Silent without notes, sounding with one")
+    {
+        REQUIRE(run(*e, 100) == 0.f);
+        e->polyNoteOn(0, 0, 60, 1);
+        REQUIRE(run(*e, 100) > 0.01f);
+    }
+
+    SECTION("A note past the polyphony steals, preferring released voices")
+    {
+        for (int k = 0; k < PolyVoices::maxVoices; ++k)
+            e->polyNoteOn(0, 0, 40 + k, k);
+        e->polyNoteOff(0, 0, 42, -1);
+        e->polyNoteOn(0, 0, 90, 100);
+
+        REQUIRE(activeVoices(*e) == PolyVoices::maxVoices);
+        bool has40{false}, has42{false}, has90{false};
+        for (auto &v : e->poly->voices)
+        {
+            has40 = has40 || v.key == 40;
+            has42 = has42 || v.key == 42;
+            has90 = has90 || v.key == 90;
+        }
+        REQUIRE(has40);
+        REQUIRE(!has42);
+        REQUIRE(has90);
+        REQUIRE(e->poly->numPendingEnds == 1);
+    }
+
+    SECTION("Each ended voice is handed back to the voice manager")
+    {
+        for (int round = 0; round < 3; ++round)
+        {
+            for (int k = 0; k < PolyVoices::maxVoices; ++k)
+                e->polyNoteOn(0, 0, 40 + k, round * 100 + k);
+            run(*e, 10);
+            for (int k = 0; k < PolyVoices::maxVoices; ++k)
+                e->polyNoteOff(0, 0, 40 + k, -1);
+            run(*e, 100);
+            REQUIRE(activeVoices(*e) == 0);
+            REQUIRE(e->poly->voiceManager.getVoiceCount() == 0);
+        }
+    }
+
+    SECTION("Released voices end after their gate")
+    {
+        e->polyNoteOn(0, 0, 60, 1);
+        e->polyNoteOn(0, 0, 64, 2);
+        run(*e, 10);
+        REQUIRE(activeVoices(*e) == 2);
+
+        e->polyNoteOff(-1, -1, -1, 2);
+        run(*e, 100);
+        REQUIRE(activeVoices(*e) == 1);
+        REQUIRE(e->poly->voices[0].key == 60);
+    }
+
+    SECTION("An ended voice's lane rings down before it is handed out again")
+    {
+        e->polyNoteOn(0, 0, 60, 1);
+        run(*e, 10);
+        e->polyNoteChoke(0, 0, 60, -1);
+        REQUIRE(activeVoices(*e) == 0);
+        REQUIRE(e->poly->voices[0].settleBlocks > 0);
+
+        e->polyNoteOn(0, 0, 64, 2);
+        REQUIRE(!e->poly->voices[0].active);
+        REQUIRE(e->poly->voices[1].key == 64);
+
+        run(*e, (int)e->poly->voices[0].settleBlocks);
+        REQUIRE(e->poly->voices[0].settleBlocks == 0);
+        e->polyNoteOn(0, 0, 67, 3);
+        REQUIRE(e->poly->voices[0].key == 67);
+    }
+
+    SECTION("Turning poly off ends every voice")
+    {
+        e->polyNoteOn(0, 0, 60, 1);
+        run(*e, 2);
+        e->patch.routingNode.polyphony = 0.f;
+        run(*e, 1);
+        REQUIRE(!e->polyMode);
+        REQUIRE(activeVoices(*e) == 0);
+    }
+}
+
+TEST_CASE("Poly keytracking and per note modulation", "[poly]")
+{
+    auto e = makePolyEngine();
+    float lfoOut[numStepLFOs]{}, noMod[numPolyModTargets]{};
+
+    auto base = e->filterControlFor(0, lfoOut, noMod, 0.f);
+    auto up = e->filterControlFor(0, lfoOut, noMod, 12.f);
+    REQUIRE(up.cutoff == Approx(base.cutoff + 12.f));
+
+    e->polyNoteOn(0, 0, 60, 7);
+    e->polyNoteOn(0, 0, 67, 8);
+    e->paramModulation(e->patch.filterNodes[1].morph.meta.id, -1, -1, -1, 8, 0.25f);
+    REQUIRE(e->poly->voices[0].mod[1][modMorph] == 0.f);
+    REQUIRE(e->poly->voices[1].mod[1][modMorph] == 0.25f);
+    REQUIRE(e->paramMod[1][modMorph] == 0.f);
+
+    e->paramModulation(e->patch.filterNodes[0].cutoff.meta.id, -1, -1, -1, -1, -3.f);
+    REQUIRE(e->paramMod[0][modCutoff] == -3.f);
+}